@@ -0,0 +1,17 @@
+#!/usr/bin/env python3
+"""Run the speed-bump overhead benchmark suite from a checkout.
+
+Thin wrapper around speed_bump.bench so the suite can be run without
+installing the package:
+
+    PYTHONPATH=src python benchmarks/bench_overhead.py [--output results.json]
+
+See speed_bump/bench.py for what is measured.
+"""
+
+import sys
+
+from speed_bump.bench import main
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -8,8 +8,10 @@ ext_modules = [
     Extension(
         "speed_bump._core",
         sources=["src/speed_bump/_core.c"],
+        depends=["src/speed_bump/_timing.h", "src/speed_bump/_matching.h"],
         extra_compile_args=extra_compile_args,
         define_macros=[("_GNU_SOURCE", "1")],
+        libraries=["m"],
     ),
 ]
 
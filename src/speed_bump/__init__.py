@@ -10,9 +10,26 @@ misses the subtle interactions between Python and GPU execution.
 Environment Variables:
     SPEED_BUMP_TARGETS: Path to file containing target patterns (one per line)
     SPEED_BUMP_DELAY_NS: Delay in nanoseconds per trigger (default: 1000)
+    SPEED_BUMP_DELAY_MODE: Delay mode, 'spin' or 'hybrid' (default: spin)
+    SPEED_BUMP_DELAY_DIST: Delay distribution, 'fixed', 'normal',
+        'exponential' or 'pareto' (default: fixed)
     SPEED_BUMP_FREQUENCY: Trigger every Nth matching call (default: 1)
+    SPEED_BUMP_RATE: Cap bumps per second per code object (0 = off)
+    SPEED_BUMP_WINDOW: Periodic duty-cycle window as on_ms:off_ms
     SPEED_BUMP_START_MS: Milliseconds after process start before enabling
     SPEED_BUMP_DURATION_MS: Duration in milliseconds (0 = indefinite)
+    SPEED_BUMP_CONTROL: Path to a command file watched for live
+        reconfiguration without a restart
+    SPEED_BUMP_COROUTINES: Bump matching coroutines/generators on every
+        resume and count frequency per asyncio task
+    SPEED_BUMP_C_CALLS: Also intercept builtin/extension calls, matched
+        by __module__ and __qualname__ (Python 3.12+ only)
+    SPEED_BUMP_RUN_DIR: Multi-process run directory: per-pid stats
+        files, a shared control file, fork-aware
+    SPEED_BUMP_ROLE: Role label for this process in the run report
+    SPEED_BUMP_CALIBRATION_CACHE: Calibration cache file path, or 'off'
+        to disable (default: ~/.cache/speed_bump/calibration)
+    SPEED_BUMP_VERBOSE: Print calibration details to stderr when set
 
 Example:
     >>> import speed_bump
@@ -24,19 +41,31 @@ Example:
 
 from speed_bump._config import Config, ConfigError, load_config
 from speed_bump._core import (
+    get_bump_overhead_ns,
+    get_callback_overhead_ns,
     get_clock_overhead_ns,
+    get_delay_dist,
     get_min_delay_ns,
+    get_timer_backend,
+    get_timer_overhead_ns,
     is_calibrated,
+    mark,
+    set_delay_dist,
     spin_delay_ns,
+    stats_dropped,
+    stats_is_enabled,
+    stats_start,
+    stats_stop,
 )
 from speed_bump._monitoring import (
     clear_cache,
     get_config,
     install,
     is_installed,
+    reconfigure,
     uninstall,
 )
-from speed_bump import native
+from speed_bump import native, stats
 
 __version__ = "0.1.0"
 __all__ = [
@@ -45,23 +74,70 @@ __all__ = [
     "ConfigError",
     "clear_cache",
     # Calibration
+    "bump_overhead_ns",
     "clock_overhead_ns",
+    "get_bump_overhead_ns",
+    "get_callback_overhead_ns",
     "get_clock_overhead_ns",
     "get_config",
+    "get_delay_dist",
     "get_min_delay_ns",
+    "get_timer_backend",
+    "get_timer_overhead_ns",
     # Monitoring
     "install",
     "is_calibrated",
     "is_installed",
     "load_config",
+    "mark",
     "min_delay_ns",
     # Native probing
     "native",
+    "recalibrate",
+    "reconfigure",
     # Delay
+    "set_delay_dist",
     "spin_delay_ns",
+    # Statistics
+    "stats",
+    "stats_dropped",
+    "stats_is_enabled",
+    "stats_start",
+    "stats_stop",
     "uninstall",
 ]
 
-# Expose calibrated values as module attributes for convenience
+# Expose calibrated values as module attributes for convenience.
+# bump_overhead_ns is the import-time snapshot (delay dispatch only);
+# use get_bump_overhead_ns() after install() for the full compensated
+# figure including the measured callback cost.
 clock_overhead_ns: int = get_clock_overhead_ns()
 min_delay_ns: int = get_min_delay_ns()
+bump_overhead_ns: int = get_bump_overhead_ns()
+
+
+def recalibrate() -> None:
+    """Re-measure clock calibration and refresh the per-host cache file.
+
+    Calibration is normally loaded from a per-host cache keyed by
+    kernel, CPU model and clocksource; call this after a suspected
+    clocksource or frequency change on a long-lived host. Refreshes the
+    module-level convenience attributes as well.
+    """
+    global clock_overhead_ns, min_delay_ns, bump_overhead_ns
+
+    from speed_bump._core import recalibrate as _core_recalibrate
+
+    _core_recalibrate()
+
+    # The 3.10/3.11 backend carries its own copy of the timing state
+    try:
+        from speed_bump._setprofile import recalibrate_setprofile
+
+        recalibrate_setprofile()
+    except ImportError:
+        pass
+
+    clock_overhead_ns = get_clock_overhead_ns()
+    min_delay_ns = get_min_delay_ns()
+    bump_overhead_ns = get_bump_overhead_ns()
@@ -3,9 +3,49 @@
 Environment Variables:
     SPEED_BUMP_TARGETS: Path to file containing target patterns (required to enable)
     SPEED_BUMP_DELAY_NS: Delay in nanoseconds per trigger (default: 1000)
+    SPEED_BUMP_DELAY_MODE: Delay mode, 'spin' or 'hybrid' (default: spin)
+    SPEED_BUMP_DELAY_DIST: Delay distribution, 'fixed', 'normal',
+        'exponential' or 'pareto' (default: fixed)
     SPEED_BUMP_FREQUENCY: Trigger every Nth matching call (default: 1)
     SPEED_BUMP_START_MS: Milliseconds after process start before enabling (default: 0)
     SPEED_BUMP_DURATION_MS: Duration in milliseconds, 0 = indefinite (default: 0)
+    SPEED_BUMP_STATS: Path for binary statistics output (default: disabled)
+    SPEED_BUMP_SWEEP: Delay sweep schedule as comma-separated
+        delay_ns:duration_ms phases, e.g. '0:60000,1000:60000,10000:60000'
+        (default: disabled)
+    SPEED_BUMP_THREADS: Comma-separated globs matched against thread
+        names and idents; only matching threads are bumped (default:
+        all threads)
+    SPEED_BUMP_CONTROL: Path to a command file watched for live
+        reconfiguration; rewrite it to swap targets/delay without
+        restarting the process (default: disabled)
+    SPEED_BUMP_STRETCH: Multiplicative slowdown factor, e.g. 1.5 makes
+        matching functions 50% slower by delaying on return in
+        proportion to each call's own measured duration, instead of by
+        the fixed SPEED_BUMP_DELAY_NS on entry (default: disabled)
+    SPEED_BUMP_COROUTINES: When set to 1, bump matching coroutines and
+        generators on every resume rather than only on the initial
+        call, and count frequency per asyncio task (default: disabled)
+    SPEED_BUMP_C_CALLS: When set to 1, also intercept calls to builtin
+        and extension functions (numpy ufuncs, tokenizer natives, ...)
+        by matching their __module__ and __qualname__ against the
+        target patterns. Python 3.12+ only (default: disabled)
+    SPEED_BUMP_RATE: Cap on bumps per second per code object (token
+        bucket refilled off the monotonic clock), as an alternative to
+        SPEED_BUMP_FREQUENCY when call rates swing between phases of a
+        run. 0 disables the cap (default: 0)
+    SPEED_BUMP_WINDOW: Periodic duty-cycle window as on_ms:off_ms,
+        e.g. '100:900' arms delays for 100ms out of every second. The
+        square wave repeats from the start of the active window, so
+        sensitivity shows up as a matching ripple in live dashboards
+        (default: always on)
+    SPEED_BUMP_RUN_DIR: Directory for a multi-process run: each process
+        writes stats to its own <run_dir>/stats.<pid>.bin and watches
+        the shared <run_dir>/control file, and forked workers re-join
+        under their own pid automatically (default: disabled)
+    SPEED_BUMP_ROLE: Free-form role label (e.g. 'rank0', 'sampler')
+        recorded in the run directory and attached to this process's
+        entry in the aggregated report (default: unset)
 """
 
 from __future__ import annotations
@@ -51,6 +91,65 @@ class Config:
     end_ns: int | None
     """Absolute time (time.time_ns) when slowdown should end, or None for indefinite."""
 
+    delay_mode: str = "spin"
+    """Delay mode: 'spin' (busy-wait the whole delay) or 'hybrid' (sleep
+    until near the deadline, then spin out the remainder)."""
+
+    stats_path: str | None = None
+    """Path for binary statistics output, or None to disable collection."""
+
+    delay_dist: str = "fixed"
+    """Delay distribution: 'fixed' applies delay_ns verbatim; 'normal',
+    'exponential' and 'pareto' sample each bump's duration with delay_ns
+    as the mean, modelling bursty rather than periodic stalls."""
+
+    sweep: tuple[tuple[int, int], ...] = ()
+    """Delay sweep schedule as (delay_ns, duration_ns) phases, stepped
+    through in order from start_ns. While a phase is active its delay
+    replaces delay_ns for patterns without their own delay override;
+    after the last phase no further delays are applied. Empty disables
+    sweeping."""
+
+    threads: tuple[str, ...] = ()
+    """Thread filter globs, matched against threading.Thread names and
+    idents (e.g. 'MainThread', 'worker-*', '140221...'). Only matching
+    threads are bumped; empty means all threads."""
+
+    control_path: str | None = None
+    """Path to a command file watched for live reconfiguration, or None
+    to disable the control plane."""
+
+    stretch: float = 0.0
+    """Multiplicative slowdown factor. When > 1.0, matching functions
+    are delayed on return in proportion to their own measured duration
+    (1.5 = 50% slower) instead of by the fixed delay_ns on entry; 0
+    disables stretch mode."""
+
+    coroutines: bool = False
+    """Bump matching coroutines and generators on every resume, not
+    just the initial call, and count frequency per asyncio task. Only
+    the PEP 669 backend needs this: sys.setprofile already reports each
+    resume as a call."""
+
+    c_calls: bool = False
+    """Also intercept calls to builtin and extension callables, matched
+    by __module__ and __qualname__ instead of source location. Closes
+    the interpreted-only visibility gap for C-implemented hot spots;
+    PEP 669 backend only."""
+
+    rate: float = 0.0
+    """Cap on bumps per second per code object, enforced by a token
+    bucket refilled off the monotonic clock. Unlike frequency's
+    every-Nth gate, the injected stall rate stays constant when the
+    call rate varies 100x between phases (prefill vs decode). Replaces
+    frequency gating for targets it applies to; 0 disables the cap."""
+
+    window: tuple[int, int] | None = None
+    """Periodic duty-cycle window as (on_ns, off_ns): delays are armed
+    for on_ns, disarmed for off_ns, repeating from start_ns for as long
+    as the outer start/end window is active. None keeps delays armed
+    continuously."""
+
     def is_in_window(self, now_ns: int | None = None) -> bool:
         """Check if the current time is within the active window.
 
@@ -72,6 +171,11 @@ class Config:
         if self.end_ns is not None and now_ns >= self.end_ns:
             return False
 
+        if self.window is not None:
+            on_ns, off_ns = self.window
+            if (now_ns - self.start_ns) % (on_ns + off_ns) >= on_ns:
+                return False  # Off phase of the duty cycle
+
         return True
 
 
@@ -79,6 +183,73 @@ class ConfigError(Exception):
     """Error in configuration."""
 
 
+def _parse_window(value: str) -> tuple[int, int]:
+    """Parse a SPEED_BUMP_WINDOW spec into (on_ns, off_ns).
+
+    The spec is on_ms:off_ms, e.g. '100:900' arms delays for 100ms out
+    of every second.
+
+    Raises:
+        ConfigError: If the spec is malformed.
+    """
+    parts = value.split(":")
+    if len(parts) != 2:
+        raise ConfigError(
+            f"SPEED_BUMP_WINDOW: invalid window '{value}' (format: on_ms:off_ms)"
+        )
+    try:
+        on_ms, off_ms = (int(part) for part in parts)
+    except ValueError:
+        raise ConfigError(
+            f"SPEED_BUMP_WINDOW: invalid integer in window '{value}'"
+        ) from None
+    if on_ms < 1 or off_ms < 1:
+        raise ConfigError(
+            f"SPEED_BUMP_WINDOW: phases must be >= 1 ms in '{value}'"
+        )
+    return (on_ms * 1_000_000, off_ms * 1_000_000)
+
+
+def _parse_sweep(value: str) -> tuple[tuple[int, int], ...]:
+    """Parse a SPEED_BUMP_SWEEP spec into (delay_ns, duration_ns) phases.
+
+    The spec is comma-separated delay_ns:duration_ms phases, e.g.
+    '0:60000,1000:60000,10000:60000' steps through 0, 1us and 10us
+    delays for 60 seconds each.
+
+    Raises:
+        ConfigError: If the spec is malformed.
+    """
+    phases: list[tuple[int, int]] = []
+
+    for part in value.split(","):
+        part = part.strip()
+        delay_str, sep, duration_str = part.partition(":")
+        if not sep:
+            raise ConfigError(
+                f"SPEED_BUMP_SWEEP: invalid phase '{part}' "
+                f"(expected delay_ns:duration_ms)"
+            )
+        try:
+            delay_ns = int(delay_str)
+            duration_ms = int(duration_str)
+        except ValueError:
+            raise ConfigError(
+                f"SPEED_BUMP_SWEEP: invalid integer in phase '{part}'"
+            ) from None
+
+        if delay_ns < 0:
+            raise ConfigError(f"SPEED_BUMP_SWEEP: negative delay in phase '{part}'")
+        if duration_ms < 1:
+            raise ConfigError(
+                f"SPEED_BUMP_SWEEP: duration must be >= 1 ms in phase '{part}'"
+            )
+
+        phases.append((delay_ns, duration_ms * 1_000_000))
+
+    return tuple(phases)
+
+
 def _parse_int(name: str, default: int, min_value: int = 0) -> int:
     """Parse an integer environment variable.
 
@@ -158,6 +329,69 @@ def load_config() -> Config:
     start_ms = _parse_int("SPEED_BUMP_START_MS", default=0, min_value=0)
     duration_ms = _parse_int("SPEED_BUMP_DURATION_MS", default=0, min_value=0)
 
+    delay_mode = os.environ.get("SPEED_BUMP_DELAY_MODE", "spin")
+    if delay_mode not in ("spin", "hybrid"):
+        raise ConfigError(
+            f"SPEED_BUMP_DELAY_MODE: invalid mode '{delay_mode}' (expected 'spin' or 'hybrid')"
+        )
+
+    delay_dist = os.environ.get("SPEED_BUMP_DELAY_DIST", "fixed")
+    if delay_dist not in ("fixed", "normal", "exponential", "pareto"):
+        raise ConfigError(
+            f"SPEED_BUMP_DELAY_DIST: invalid distribution '{delay_dist}' "
+            f"(expected 'fixed', 'normal', 'exponential' or 'pareto')"
+        )
+
+    stats_path = os.environ.get("SPEED_BUMP_STATS") or None
+
+    sweep_spec = os.environ.get("SPEED_BUMP_SWEEP")
+    sweep = _parse_sweep(sweep_spec) if sweep_spec else ()
+
+    window_spec = os.environ.get("SPEED_BUMP_WINDOW")
+    window = _parse_window(window_spec) if window_spec else None
+
+    threads_spec = os.environ.get("SPEED_BUMP_THREADS", "")
+    threads = tuple(part.strip() for part in threads_spec.split(",") if part.strip())
+
+    control_path = os.environ.get("SPEED_BUMP_CONTROL") or None
+
+    run_dir = os.environ.get("SPEED_BUMP_RUN_DIR") or None
+    if run_dir is not None:
+        stats_path, control_path = _enter_run_dir(run_dir, stats_path, control_path)
+
+    stretch_str = os.environ.get("SPEED_BUMP_STRETCH")
+    if stretch_str:
+        try:
+            stretch = float(stretch_str)
+        except ValueError:
+            raise ConfigError(
+                f"SPEED_BUMP_STRETCH: invalid factor '{stretch_str}'"
+            ) from None
+        if stretch < 1.0:
+            raise ConfigError(
+                f"SPEED_BUMP_STRETCH: factor {stretch} is below 1.0 "
+                f"(functions cannot be sped up)"
+            )
+    else:
+        stretch = 0.0
+
+    coroutines_str = os.environ.get("SPEED_BUMP_COROUTINES", "")
+    coroutines = coroutines_str.strip() not in ("", "0")
+
+    c_calls_str = os.environ.get("SPEED_BUMP_C_CALLS", "")
+    c_calls = c_calls_str.strip() not in ("", "0")
+
+    rate_str = os.environ.get("SPEED_BUMP_RATE")
+    if rate_str:
+        try:
+            rate = float(rate_str)
+        except ValueError:
+            raise ConfigError(f"SPEED_BUMP_RATE: invalid rate '{rate_str}'") from None
+        if rate < 0:
+            raise ConfigError(f"SPEED_BUMP_RATE: rate {rate} is negative")
+    else:
+        rate = 0.0
+
     # Validate delay against minimum
     min_delay = get_min_delay_ns()
     if delay_ns < min_delay:
@@ -182,6 +416,17 @@ def load_config() -> Config:
         frequency=frequency,
         start_ns=start_ns,
         end_ns=end_ns,
+        delay_mode=delay_mode,
+        stats_path=stats_path,
+        delay_dist=delay_dist,
+        sweep=sweep,
+        window=window,
+        threads=threads,
+        control_path=control_path,
+        stretch=stretch,
+        coroutines=coroutines,
+        c_calls=c_calls,
+        rate=rate,
     )
 
     # Report configuration
@@ -190,6 +435,105 @@ def load_config() -> Config:
     return config
 
 
+# Active run directory (SPEED_BUMP_RUN_DIR), shared by the at-fork hook
+_run_dir: str | None = None
+_fork_hook_registered: bool = False
+
+
+def _run_stats_path(run_dir: str) -> str:
+    """Per-process stats file path inside a run directory."""
+    return str(Path(run_dir) / f"stats.{os.getpid()}.bin")
+
+
+def _write_run_meta(run_dir: str) -> None:
+    """Record this process in the run directory.
+
+    One proc.<pid> file per process, command-file style key/value
+    lines; the aggregator joins it against the pid's stats file. Best
+    effort: a worker that cannot write its meta still collects stats.
+    """
+    role = os.environ.get("SPEED_BUMP_ROLE", "").strip()
+    try:
+        meta = Path(run_dir) / f"proc.{os.getpid()}"
+        lines = []
+        if role:
+            lines.append(f"role {role}\n")
+        meta.write_text("".join(lines))
+    except OSError:
+        pass
+
+
+def _enter_run_dir(
+    run_dir: str, stats_path: str | None, control_path: str | None
+) -> tuple[str | None, str | None]:
+    """Join a multi-process run directory.
+
+    Every process of the run derives its own stats file from its pid
+    (unless SPEED_BUMP_STATS names one explicitly) and watches the
+    shared control file, so one rewrite of <run_dir>/control propagates
+    to all workers - each worker's own watcher thread picks it up. The
+    environment itself is the propagation channel for the base config:
+    fork and spawn both inherit it.
+    """
+    global _run_dir, _fork_hook_registered
+
+    try:
+        os.makedirs(run_dir, exist_ok=True)
+    except OSError as e:
+        raise ConfigError(f"SPEED_BUMP_RUN_DIR: cannot create {run_dir}: {e}") from None
+
+    if stats_path is None:
+        stats_path = _run_stats_path(run_dir)
+    if control_path is None:
+        control_path = str(Path(run_dir) / "control")
+
+    _write_run_meta(run_dir)
+
+    _run_dir = run_dir
+    if not _fork_hook_registered:
+        # Spawned workers re-import and land here on their own; forked
+        # workers inherit live state and need it re-pointed at their
+        # own pid's files
+        os.register_at_fork(after_in_child=_after_fork_in_child)
+        _fork_hook_registered = True
+
+    return stats_path, control_path
+
+
+def _after_fork_in_child() -> None:
+    """Re-establish per-process run state in a forked worker.
+
+    The parent's stats flusher and control watcher threads do not
+    survive the fork: discard the inherited stats session (the parent
+    keeps its file), start a fresh one under the child's pid, and
+    restart the watcher on the shared control file.
+    """
+    run_dir = _run_dir
+    if run_dir is None:
+        return
+
+    from speed_bump._core import stats_fork_reset, stats_is_enabled, stats_start
+
+    had_stats = stats_is_enabled()
+    stats_fork_reset()
+    _write_run_meta(run_dir)
+
+    from speed_bump import _control, _monitoring
+
+    config = _monitoring.get_config()
+    if had_stats:
+        metadata = (
+            _monitoring._stats_metadata(config) if config is not None else None
+        )
+        try:
+            stats_start(_run_stats_path(run_dir), metadata)
+        except (OSError, RuntimeError):
+            pass  # The child keeps running unmonitored rather than dying
+
+    if config is not None and config.control_path is not None:
+        _control.restart_after_fork(config.control_path)
+
+
 def _warn(message: str) -> None:
     """Print a warning to stderr."""
     print(f"speed_bump: WARNING: {message}", file=sys.stderr)
@@ -202,13 +546,68 @@ def _report_config(config: Config, targets_path: str) -> None:
         file=sys.stderr,
     )
     print(
-        f"speed_bump: delay: {config.delay_ns} ns, frequency: {config.frequency}", file=sys.stderr
+        f"speed_bump: delay: {config.delay_ns} ns, frequency: {config.frequency}, "
+        f"mode: {config.delay_mode}, distribution: {config.delay_dist}",
+        file=sys.stderr,
     )
 
     if config.start_ns > _PROCESS_START_NS:
         start_offset_ms = (config.start_ns - _PROCESS_START_NS) // 1_000_000
         print(f"speed_bump: start delay: {start_offset_ms} ms", file=sys.stderr)
 
+    if config.stats_path is not None:
+        print(f"speed_bump: statistics: {config.stats_path}", file=sys.stderr)
+
+    if _run_dir is not None:
+        role = os.environ.get("SPEED_BUMP_ROLE", "").strip()
+        suffix = f" (role: {role})" if role else ""
+        print(f"speed_bump: run directory: {_run_dir}{suffix}", file=sys.stderr)
+
+    if config.sweep:
+        phases = ", ".join(
+            f"{delay_ns} ns x {duration_ns // 1_000_000} ms"
+            for delay_ns, duration_ns in config.sweep
+        )
+        print(f"speed_bump: sweep: {phases}", file=sys.stderr)
+
+    if config.window is not None:
+        on_ns, off_ns = config.window
+        print(
+            f"speed_bump: window: {on_ns // 1_000_000} ms on / "
+            f"{off_ns // 1_000_000} ms off",
+            file=sys.stderr,
+        )
+
+    if config.threads:
+        print(f"speed_bump: threads: {', '.join(config.threads)}", file=sys.stderr)
+
+    if config.control_path is not None:
+        print(f"speed_bump: control file: {config.control_path}", file=sys.stderr)
+
+    if config.stretch > 1.0:
+        print(
+            f"speed_bump: stretch: {config.stretch}x (proportional delay on return)",
+            file=sys.stderr,
+        )
+
+    if config.coroutines:
+        print(
+            "speed_bump: coroutines: bumping per resume, frequency per task",
+            file=sys.stderr,
+        )
+
+    if config.c_calls:
+        print(
+            "speed_bump: c_calls: intercepting builtin/extension calls",
+            file=sys.stderr,
+        )
+
+    if config.rate > 0:
+        print(
+            f"speed_bump: rate: {config.rate} bumps/s per code object",
+            file=sys.stderr,
+        )
+
     if config.end_ns is not None:
         duration_ms = (config.end_ns - config.start_ns) // 1_000_000
         print(f"speed_bump: duration: {duration_ms} ms", file=sys.stderr)
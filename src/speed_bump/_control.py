@@ -0,0 +1,269 @@
+"""Live runtime control plane for reconfiguration without restart.
+
+When SPEED_BUMP_CONTROL names a command file, a daemon thread watches
+its modification time and applies the commands whenever it changes.
+This lets a warm, long-lived process (e.g. an inference server with a
+multi-minute startup) be re-targeted interactively instead of paying a
+cold start per hypothesis.
+
+Command file format, one command per line:
+
+    # Comments start with #
+    targets /path/to/new_targets.txt
+    delay_ns 50000
+    frequency 10
+    rate 200
+    window 100:900
+    delay_mode hybrid
+    delay_dist pareto
+    threads MainThread,worker-*
+    stretch 1.5
+    coroutines 1
+    c_calls 1
+
+Only the keys present are changed; everything else keeps its current
+value. A file that already exists when the watcher starts is treated as
+stale (left over from a previous run) and ignored until rewritten.
+Malformed commands are reported to stderr and skipped without touching
+the live configuration.
+"""
+
+from __future__ import annotations
+
+import dataclasses
+import sys
+import threading
+from pathlib import Path
+
+from speed_bump._config import ConfigError
+from speed_bump._patterns import load_targets
+
+# How often the watcher thread checks the command file's mtime
+_POLL_INTERVAL_S = 0.5
+
+_watcher: threading.Thread | None = None
+_stop_event = threading.Event()
+
+_VALID_DELAY_MODES = ("spin", "hybrid")
+_VALID_DELAY_DISTS = ("fixed", "normal", "exponential", "pareto")
+
+
+def parse_command_file(path: Path) -> dict[str, str]:
+    """Parse a command file into a {key: value} dict.
+
+    Lines are 'key value'; blank lines and # comments are skipped.
+
+    Raises:
+        ConfigError: If a line has no value or a key is repeated.
+    """
+    commands: dict[str, str] = {}
+
+    for line_num, line in enumerate(path.read_text().splitlines(), start=1):
+        line = line.strip()
+        if not line or line.startswith("#"):
+            continue
+
+        key, _, value = line.partition(" ")
+        value = value.strip()
+        if not value:
+            raise ConfigError(f"control: line {line_num}: missing value for '{key}'")
+        if key in commands:
+            raise ConfigError(f"control: line {line_num}: duplicate key '{key}'")
+        commands[key] = value
+
+    return commands
+
+
+def apply_commands(commands: dict[str, str]) -> None:
+    """Apply parsed commands to the live configuration.
+
+    Builds a new Config from the current one with the commanded fields
+    replaced and swaps it in via reconfigure().
+
+    Raises:
+        ConfigError: If a command is invalid.
+        RuntimeError: If monitoring is not installed.
+    """
+    from speed_bump import _monitoring
+
+    config = _monitoring.get_config()
+    if config is None:
+        raise ConfigError("control: no active configuration to modify")
+
+    changes: dict[str, object] = {}
+
+    for key, value in commands.items():
+        if key == "targets":
+            targets_path = Path(value)
+            if not targets_path.exists():
+                raise ConfigError(f"control: targets file not found: {value}")
+            try:
+                targets = load_targets(targets_path)
+            except Exception as e:
+                raise ConfigError(f"control: targets: {e}") from None
+            if not targets:
+                raise ConfigError(f"control: no patterns found in {value}")
+            changes["targets"] = tuple(targets)
+        elif key == "delay_ns":
+            delay_ns = _parse_int(key, value)
+            if delay_ns < 0:
+                raise ConfigError(f"control: delay_ns must be >= 0, got {delay_ns}")
+            changes["delay_ns"] = delay_ns
+        elif key == "frequency":
+            frequency = _parse_int(key, value)
+            if frequency < 1:
+                raise ConfigError(f"control: frequency must be >= 1, got {frequency}")
+            changes["frequency"] = frequency
+        elif key == "delay_mode":
+            if value not in _VALID_DELAY_MODES:
+                raise ConfigError(f"control: invalid delay_mode '{value}'")
+            changes["delay_mode"] = value
+        elif key == "delay_dist":
+            if value not in _VALID_DELAY_DISTS:
+                raise ConfigError(f"control: invalid delay_dist '{value}'")
+            changes["delay_dist"] = value
+        elif key == "threads":
+            changes["threads"] = tuple(
+                part.strip() for part in value.split(",") if part.strip()
+            )
+        elif key == "stretch":
+            try:
+                stretch = float(value)
+            except ValueError:
+                raise ConfigError(f"control: stretch: invalid factor '{value}'") from None
+            if stretch != 0.0 and stretch < 1.0:
+                raise ConfigError(
+                    f"control: stretch must be >= 1.0 (or 0 to disable), got {stretch}"
+                )
+            changes["stretch"] = stretch
+        elif key == "rate":
+            try:
+                rate = float(value)
+            except ValueError:
+                raise ConfigError(f"control: rate: invalid rate '{value}'") from None
+            if rate < 0:
+                raise ConfigError(f"control: rate must be >= 0, got {rate}")
+            changes["rate"] = rate
+        elif key == "window":
+            if value in ("0", "off"):
+                changes["window"] = None
+            else:
+                try:
+                    on_ms, off_ms = (int(part) for part in value.split(":"))
+                except ValueError:
+                    raise ConfigError(
+                        f"control: window: invalid spec '{value}' "
+                        f"(format: on_ms:off_ms, or 0 to disable)"
+                    ) from None
+                if on_ms < 1 or off_ms < 1:
+                    raise ConfigError(
+                        f"control: window phases must be >= 1 ms, got '{value}'"
+                    )
+                changes["window"] = (on_ms * 1_000_000, off_ms * 1_000_000)
+        elif key == "coroutines":
+            if value not in ("0", "1"):
+                raise ConfigError(
+                    f"control: coroutines must be 0 or 1, got '{value}'"
+                )
+            changes["coroutines"] = value == "1"
+        elif key == "c_calls":
+            if value not in ("0", "1"):
+                raise ConfigError(
+                    f"control: c_calls must be 0 or 1, got '{value}'"
+                )
+            changes["c_calls"] = value == "1"
+        else:
+            raise ConfigError(f"control: unknown command '{key}'")
+
+    if not changes:
+        return
+
+    _monitoring.reconfigure(dataclasses.replace(config, **changes))
+
+    applied = ", ".join(sorted(changes))
+    print(f"speed_bump: control: applied {applied}", file=sys.stderr)
+
+
+def _parse_int(key: str, value: str) -> int:
+    try:
+        return int(value)
+    except ValueError:
+        raise ConfigError(f"control: {key}: invalid integer '{value}'") from None
+
+
+def _watch(path: Path, poll_interval_s: float, last_mtime: int | None) -> None:
+    """Watcher thread body: poll the command file's mtime and apply it
+    on change. Errors are reported and the watcher keeps running, so a
+    bad command file can simply be rewritten."""
+    while not _stop_event.wait(poll_interval_s):
+        try:
+            mtime = path.stat().st_mtime_ns
+        except OSError:
+            continue
+
+        if mtime == last_mtime:
+            continue
+        last_mtime = mtime
+
+        try:
+            commands = parse_command_file(path)
+            if commands:
+                apply_commands(commands)
+        except Exception as e:
+            print(f"speed_bump: WARNING: {e}", file=sys.stderr)
+
+
+def start(control_path: str, poll_interval_s: float = _POLL_INTERVAL_S) -> None:
+    """Start watching a command file. No-op if already watching."""
+    global _watcher
+
+    if _watcher is not None and _watcher.is_alive():
+        return
+
+    path = Path(control_path)
+
+    # Baseline the mtime here, not in the thread: a file that already
+    # exists is stale (left over from a previous run), but anything
+    # written after this point must be picked up
+    try:
+        last_mtime: int | None = path.stat().st_mtime_ns
+    except OSError:
+        last_mtime = None
+
+    _stop_event.clear()
+    _watcher = threading.Thread(
+        target=_watch,
+        args=(path, poll_interval_s, last_mtime),
+        name="speed-bump-control",
+        daemon=True,
+    )
+    _watcher.start()
+
+
+def restart_after_fork(control_path: str) -> None:
+    """Restart the watcher in a forked child process.
+
+    The parent's watcher thread does not survive the fork; drop the
+    stale Thread object and start a fresh watcher on the same file.
+    """
+    global _watcher
+
+    _watcher = None
+    start(control_path)
+
+
+def stop() -> None:
+    """Stop the watcher thread. No-op if not running."""
+    global _watcher
+
+    if _watcher is None:
+        return
+
+    _stop_event.set()
+    _watcher.join(timeout=5.0)
+    _watcher = None
+
+
+def is_running() -> bool:
+    """Check if the control file watcher is running."""
+    return _watcher is not None and _watcher.is_alive()
@@ -14,88 +14,54 @@
 #include <stdio.h>
 #include <stdbool.h>
 
-/* Architecture-specific pause instruction */
-#ifdef __x86_64__
-#include <immintrin.h>
-#define CPU_PAUSE() _mm_pause()
-#elif defined(__aarch64__)
-#define CPU_PAUSE() __asm__ __volatile__("yield")
-#else
-#define CPU_PAUSE() ((void)0)
-#endif
-
-/* ============================================================================
- * Module State
+/* Shared timing backend: calibration state, spin_delay_ns, CPU_PAUSE.
  *
  * Thread-safety notes:
- * - g_clock_overhead_ns and g_calibrated are written once during module init
+ * - Calibration state is written once during module init
  * - Python's import machinery serialises module init (even on FTP)
- * - After init, these are read-only and safe to access from any thread
+ * - After init, the state is read-only and safe to access from any thread
  * - spin_delay_ns() uses only local variables and is fully thread-safe
  *
  * Verified with ThreadSanitizer: spin_delay_ns shows no races when called
- * from 8 concurrent threads. calibrate_clock would race if called
+ * from 8 concurrent threads. Calibration would race if called
  * concurrently, but this never happens due to import serialisation.
- * ============================================================================ */
-
-static uint64_t g_clock_overhead_ns = 0;
-static bool g_calibrated = false;
-
-/* ============================================================================
- * Time Utilities
- * ============================================================================ */
+ */
+#include "_timing.h"
 
-static inline uint64_t timespec_to_ns(const struct timespec *ts) {
-    return (uint64_t)ts->tv_sec * 1000000000ULL + (uint64_t)ts->tv_nsec;
-}
+/* Statistics collection: per-thread rings plus background flusher.
+ * _setprofile records through the capsule exported below. */
+#include "_stats.h"
 
 /* ============================================================================
  * Calibration
  * ============================================================================ */
 
-static void calibrate_clock(void) {
-    struct timespec ts, start, end;
-    const int WARMUP = 1000;
-    const int ITERS = 100000;
-
-    /* Warmup - prime caches and TLB */
-    for (int i = 0; i < WARMUP; i++) {
-        clock_gettime(CLOCK_MONOTONIC, &ts);
-    }
-
-    /* Measure */
-    clock_gettime(CLOCK_MONOTONIC, &start);
-    for (int i = 0; i < ITERS; i++) {
-        clock_gettime(CLOCK_MONOTONIC, &ts);
-    }
-    clock_gettime(CLOCK_MONOTONIC, &end);
-
-    uint64_t elapsed = timespec_to_ns(&end) - timespec_to_ns(&start);
-    g_clock_overhead_ns = elapsed / ITERS;
-    g_calibrated = true;
+/* Calibration details only go to stderr when SPEED_BUMP_VERBOSE is
+ * set: the lines appear on every import, and unconditional chatter
+ * corrupts harnesses that speak a protocol on stderr. */
+static bool speed_bump_verbose(void) {
+    const char *value = getenv("SPEED_BUMP_VERBOSE");
+    return value != NULL && *value != '\0' && strcmp(value, "0") != 0;
+}
 
+static void report_calibration(void) {
+    fprintf(stderr, "speed_bump: calibration: %s\n",
+            timing_calibration_loaded() ? "loaded from per-host cache" : "measured");
     fprintf(stderr, "speed_bump: clock_gettime overhead: %lu ns\n",
             (unsigned long)g_clock_overhead_ns);
+    fprintf(stderr, "speed_bump: timer backend: %s (%lu ns per read)\n",
+            timing_backend_name(),
+            (unsigned long)timing_read_overhead_ns());
     fprintf(stderr, "speed_bump: minimum achievable delay: %lu ns\n",
-            (unsigned long)(2 * g_clock_overhead_ns));
+            (unsigned long)timing_min_delay_ns());
 }
 
-/* ============================================================================
- * Spin Delay
- * ============================================================================ */
-
-static void spin_delay_ns(uint64_t delay_ns) {
-    struct timespec start, now;
-
-    clock_gettime(CLOCK_MONOTONIC, &start);
-    uint64_t end_ns = timespec_to_ns(&start) + delay_ns;
+static void calibrate_clock(void) {
+    timing_calibrate();
+    timing_calibrate_dispatch();
 
-    for (;;) {
-        clock_gettime(CLOCK_MONOTONIC, &now);
-        if (timespec_to_ns(&now) >= end_ns) {
-            break;
-        }
-        CPU_PAUSE();
+    if (speed_bump_verbose()) {
+        report_calibration();
     }
 }
 
@@ -127,6 +93,122 @@ static PyObject* py_spin_delay_ns(PyObject* self, PyObject* args) {
     Py_RETURN_NONE;
 }
 
+PyDoc_STRVAR(py_apply_delay_ns_doc,
+"apply_delay_ns(nanoseconds)\n"
+"\n"
+"Delay for the specified number of nanoseconds using the configured\n"
+"delay mode.\n"
+"\n"
+"In 'spin' mode this is identical to spin_delay_ns. In 'hybrid' mode,\n"
+"delays above the calibrated sleep/spin crossover sleep until shortly\n"
+"before the deadline and spin out the remainder. When a stochastic\n"
+"delay distribution is configured, the argument is the distribution\n"
+"mean and each call's actual duration is sampled from it.\n"
+"\n"
+"Args:\n"
+"    nanoseconds: Number of nanoseconds to delay (uint64).\n"
+"\n"
+"Returns:\n"
+"    int: The delay actually applied, in nanoseconds.\n"
+);
+
+static PyObject* py_apply_delay_ns(PyObject* self, PyObject* args) {
+    (void)self;
+    unsigned long long delay;
+
+    if (!PyArg_ParseTuple(args, "K", &delay)) {
+        return NULL;
+    }
+
+    uint64_t applied = apply_delay_ns((uint64_t)delay);
+    return PyLong_FromUnsignedLongLong(applied);
+}
+
+PyDoc_STRVAR(py_set_delay_mode_doc,
+"set_delay_mode(mode)\n"
+"\n"
+"Set the delay mode for apply_delay_ns.\n"
+"\n"
+"Args:\n"
+"    mode: 'spin' (busy-wait for the whole delay) or 'hybrid'\n"
+"    (clock_nanosleep until near the deadline, then spin).\n"
+);
+
+static PyObject* py_set_delay_mode(PyObject* self, PyObject* args) {
+    (void)self;
+    const char *mode;
+
+    if (!PyArg_ParseTuple(args, "s", &mode)) {
+        return NULL;
+    }
+
+    if (timing_set_delay_mode(mode) < 0) {
+        PyErr_Format(PyExc_ValueError, "unknown delay mode '%s'", mode);
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(py_get_delay_mode_doc,
+"get_delay_mode()\n"
+"\n"
+"Get the current delay mode.\n"
+"\n"
+"Returns:\n"
+"    str: 'spin' or 'hybrid'.\n"
+);
+
+static PyObject* py_get_delay_mode(PyObject* self, PyObject* args) {
+    (void)self;
+    (void)args;
+    return PyUnicode_FromString(
+        g_delay_mode == DELAY_MODE_HYBRID ? "hybrid" : "spin");
+}
+
+PyDoc_STRVAR(py_set_delay_dist_doc,
+"set_delay_dist(dist)\n"
+"\n"
+"Set the delay distribution for apply_delay_ns.\n"
+"\n"
+"With 'fixed' (the default) every call delays exactly the requested\n"
+"amount. The stochastic distributions sample each bump's duration with\n"
+"the requested delay as the mean, modelling bursty contention instead\n"
+"of perfectly periodic stalls.\n"
+"\n"
+"Args:\n"
+"    dist: 'fixed', 'normal', 'exponential' or 'pareto'.\n"
+);
+
+static PyObject* py_set_delay_dist(PyObject* self, PyObject* args) {
+    (void)self;
+    const char *dist;
+
+    if (!PyArg_ParseTuple(args, "s", &dist)) {
+        return NULL;
+    }
+
+    if (timing_set_delay_dist(dist) < 0) {
+        PyErr_Format(PyExc_ValueError, "unknown delay distribution '%s'", dist);
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(py_get_delay_dist_doc,
+"get_delay_dist()\n"
+"\n"
+"Get the current delay distribution.\n"
+"\n"
+"Returns:\n"
+"    str: 'fixed', 'normal', 'exponential' or 'pareto'.\n"
+);
+
+static PyObject* py_get_delay_dist(PyObject* self, PyObject* args) {
+    (void)self;
+    (void)args;
+    return PyUnicode_FromString(timing_delay_dist_name());
+}
+
 PyDoc_STRVAR(py_get_clock_overhead_ns_doc,
 "get_clock_overhead_ns()\n"
 "\n"
@@ -147,8 +229,8 @@ PyDoc_STRVAR(py_get_min_delay_ns_doc,
 "\n"
 "Get the minimum achievable delay in nanoseconds.\n"
 "\n"
-"This is 2x the clock_gettime overhead, since spin_delay_ns\n"
-"requires at least two clock reads (start and end).\n"
+"This is 2x the read overhead of the active timer backend, since\n"
+"spin_delay_ns requires at least two timer reads (start and end).\n"
 "\n"
 "Returns:\n"
 "    int: The minimum achievable delay.\n"
@@ -157,7 +239,123 @@ PyDoc_STRVAR(py_get_min_delay_ns_doc,
 static PyObject* py_get_min_delay_ns(PyObject* self, PyObject* args) {
     (void)self;
     (void)args;
-    return PyLong_FromUnsignedLongLong(2 * g_clock_overhead_ns);
+    return PyLong_FromUnsignedLongLong(timing_min_delay_ns());
+}
+
+PyDoc_STRVAR(py_get_timer_overhead_ns_doc,
+"get_timer_overhead_ns()\n"
+"\n"
+"Get the per-read overhead of the active timer backend.\n"
+"\n"
+"This is the cycle-counter read cost when the cycle backend was\n"
+"selected at calibration time, otherwise the clock_gettime overhead.\n"
+"\n"
+"Returns:\n"
+"    int: The measured overhead per timer read.\n"
+);
+
+static PyObject* py_get_timer_overhead_ns(PyObject* self, PyObject* args) {
+    (void)self;
+    (void)args;
+    return PyLong_FromUnsignedLongLong(timing_read_overhead_ns());
+}
+
+PyDoc_STRVAR(py_get_bump_overhead_ns_doc,
+"get_bump_overhead_ns()\n"
+"\n"
+"Get the total fixed per-bump overhead in nanoseconds.\n"
+"\n"
+"This is the amount apply_delay_ns subtracts from each requested delay\n"
+"so the observed stall matches the requested one: the delay dispatch's\n"
+"own cost (measured at calibration) plus the monitoring callback's\n"
+"cost (measured at install time, zero before the first install).\n"
+"\n"
+"Returns:\n"
+"    int: The compensated per-bump overhead.\n"
+);
+
+static PyObject* py_get_bump_overhead_ns(PyObject* self, PyObject* args) {
+    (void)self;
+    (void)args;
+    return PyLong_FromUnsignedLongLong(timing_bump_overhead_ns());
+}
+
+PyDoc_STRVAR(py_get_callback_overhead_ns_doc,
+"get_callback_overhead_ns()\n"
+"\n"
+"Get the raw measured per-bump monitoring callback overhead.\n"
+"\n"
+"Returns:\n"
+"    int: The callback overhead in nanoseconds (zero before the first\n"
+"    install).\n"
+);
+
+static PyObject* py_get_callback_overhead_ns(PyObject* self, PyObject* args) {
+    (void)self;
+    (void)args;
+    return PyLong_FromUnsignedLongLong(g_callback_overhead_ns);
+}
+
+PyDoc_STRVAR(py_set_callback_overhead_ns_doc,
+"set_callback_overhead_ns(nanoseconds)\n"
+"\n"
+"Record the measured per-bump cost of the active monitoring callback.\n"
+"\n"
+"Set by install() after timing a probe function with and without the\n"
+"callback attached; subtracted from every requested delay thereafter.\n"
+"\n"
+"Args:\n"
+"    nanoseconds: Measured callback overhead (uint64).\n"
+);
+
+static PyObject* py_set_callback_overhead_ns(PyObject* self, PyObject* args) {
+    (void)self;
+    unsigned long long overhead;
+
+    if (!PyArg_ParseTuple(args, "K", &overhead)) {
+        return NULL;
+    }
+
+    timing_set_callback_overhead_ns((uint64_t)overhead);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(py_get_timer_backend_doc,
+"get_timer_backend()\n"
+"\n"
+"Get the name of the timer backend selected at calibration time.\n"
+"\n"
+"Returns:\n"
+"    str: 'tsc' (x86 invariant TSC), 'cntvct' (aarch64 virtual\n"
+"    counter), or 'clock_gettime' (fallback).\n"
+);
+
+static PyObject* py_get_timer_backend(PyObject* self, PyObject* args) {
+    (void)self;
+    (void)args;
+    return PyUnicode_FromString(timing_backend_name());
+}
+
+PyDoc_STRVAR(py_recalibrate_doc,
+"recalibrate()\n"
+"\n"
+"Discard the current calibration (cached or measured), re-measure the\n"
+"clock overheads and rewrite the per-host calibration cache file.\n"
+"\n"
+"Use after a suspected clocksource or frequency change on a long-lived\n"
+"host. The measured monitoring-callback overhead is preserved; it\n"
+"belongs to the installed backend, not to the host clock.\n"
+);
+
+static PyObject* py_recalibrate(PyObject* self, PyObject* args) {
+    (void)self;
+    (void)args;
+
+    timing_recalibrate();
+    if (speed_bump_verbose()) {
+        report_calibration();
+    }
+    Py_RETURN_NONE;
 }
 
 PyDoc_STRVAR(py_is_calibrated_doc,
@@ -175,16 +373,731 @@ static PyObject* py_is_calibrated(PyObject* self, PyObject* args) {
     return PyBool_FromLong(g_calibrated);
 }
 
+/* ============================================================================
+ * Statistics API
+ * ============================================================================ */
+
+PyDoc_STRVAR(py_stats_start_doc,
+"stats_start(path, metadata=None)\n"
+"\n"
+"Start statistics collection, writing binary records to path.\n"
+"\n"
+"Each applied bump is recorded as (code_id, timestamp, delay_ns) in a\n"
+"per-thread lock-free ring, drained to the file by a background\n"
+"flusher thread. Records are dropped (and counted) if a ring fills.\n"
+"\n"
+"The file header carries the calibration constants and, when given,\n"
+"the metadata string ('key value' lines describing the resolved\n"
+"configuration) so the file is self-describing for offline analysis.\n"
+"\n"
+"Args:\n"
+"    path: Output file path.\n"
+"    metadata: Optional UTF-8 string stored in the file header.\n"
+"\n"
+"Raises:\n"
+"    RuntimeError: If collection is already running.\n"
+"    OSError: If the file cannot be opened.\n"
+);
+
+static PyObject* py_stats_start(PyObject* self, PyObject* args) {
+    (void)self;
+    const char *path;
+    const char *meta = NULL;
+    Py_ssize_t meta_len = 0;
+
+    if (!PyArg_ParseTuple(args, "s|z#", &path, &meta, &meta_len)) {
+        return NULL;
+    }
+
+    int rc = stats_start(path, meta, (size_t)meta_len);
+    if (rc == -1) {
+        PyErr_SetString(PyExc_RuntimeError, "statistics collection already running");
+        return NULL;
+    }
+    if (rc == -2) {
+        PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+        return NULL;
+    }
+    if (rc == -3) {
+        PyErr_SetString(PyExc_RuntimeError, "failed to start stats flusher thread");
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(py_stats_stop_doc,
+"stats_stop()\n"
+"\n"
+"Stop statistics collection, draining all rings and closing the file.\n"
+"\n"
+"No-op if collection is not running.\n"
+);
+
+static PyObject* py_stats_stop(PyObject* self, PyObject* args) {
+    (void)self;
+    (void)args;
+
+    /* The flusher join can block briefly; release the GIL around it */
+    Py_BEGIN_ALLOW_THREADS
+    stats_stop();
+    Py_END_ALLOW_THREADS
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(py_stats_is_enabled_doc,
+"stats_is_enabled()\n"
+"\n"
+"Check if statistics collection is running.\n"
+"\n"
+"Returns:\n"
+"    bool: True if collection is running.\n"
+);
+
+static PyObject* py_stats_is_enabled(PyObject* self, PyObject* args) {
+    (void)self;
+    (void)args;
+    return PyBool_FromLong(
+        atomic_load_explicit(&g_stats_enabled, memory_order_relaxed));
+}
+
+PyDoc_STRVAR(py_stats_dropped_doc,
+"stats_dropped()\n"
+"\n"
+"Get the number of records dropped because a ring was full.\n"
+"\n"
+"Returns:\n"
+"    int: Total dropped records in the current session.\n"
+);
+
+static PyObject* py_stats_dropped(PyObject* self, PyObject* args) {
+    (void)self;
+    (void)args;
+    return PyLong_FromUnsignedLongLong(stats_dropped_total());
+}
+
+PyDoc_STRVAR(py_stats_record_doc,
+"stats_record(code_id, delay_ns)\n"
+"\n"
+"Record one applied bump. Used by the Python monitoring handler;\n"
+"the C backends record directly.\n"
+"\n"
+"Args:\n"
+"    code_id: id() of the bumped code object.\n"
+"    delay_ns: The delay that was applied.\n"
+);
+
+static PyObject* py_stats_record(PyObject* self, PyObject* args) {
+    (void)self;
+    unsigned long long code_id, delay_ns;
+
+    if (!PyArg_ParseTuple(args, "KK", &code_id, &delay_ns)) {
+        return NULL;
+    }
+
+    stats_record((uint64_t)code_id, (uint64_t)delay_ns);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(py_stats_fork_reset_doc,
+"stats_fork_reset()\n"
+"\n"
+"Reset statistics state in a child process after fork().\n"
+"\n"
+"The flusher thread does not survive a fork, so stats_stop() would\n"
+"deadlock in the child. This discards the inherited session - without\n"
+"writing anything into the parent's file - so the child can start its\n"
+"own collection with stats_start(). No-op if collection is not\n"
+"running.\n"
+);
+
+static PyObject* py_stats_fork_reset(PyObject* self, PyObject* args) {
+    (void)self;
+    (void)args;
+
+    stats_fork_reset();
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(py_mark_doc,
+"mark(units=1, /)\n"
+"\n"
+"Record a throughput marker: units of work completed at this instant.\n"
+"\n"
+"Writes a (timestamp, unit count) record into the same per-thread ring\n"
+"as the bump statistics, so one output stream carries both delays\n"
+"applied and work completed and sensitivity can be computed per timing\n"
+"window or sweep phase. Cheap enough for a per-token loop: no\n"
+"allocation, no lock, a no-op when collection is disabled.\n"
+"\n"
+"Args:\n"
+"    units: Number of work units completed (default 1).\n"
+);
+
+static PyObject* py_mark(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
+    (void)self;
+    uint64_t units = 1;
+
+    if (nargs > 1) {
+        PyErr_SetString(PyExc_TypeError, "mark() takes at most 1 argument");
+        return NULL;
+    }
+    if (nargs == 1) {
+        unsigned long long v = PyLong_AsUnsignedLongLong(args[0]);
+        if (v == (unsigned long long)-1 && PyErr_Occurred()) {
+            return NULL;
+        }
+        units = (uint64_t)v;
+    }
+
+    stats_record(THROUGHPUT_MARKER_ID, units);
+    Py_RETURN_NONE;
+}
+
+/* ============================================================================
+ * PEP 669 Monitoring (Python 3.12+)
+ *
+ * Native PY_START callback so the per-matching-call hot path (cache
+ * lookup, window check, frequency counter, delay) never enters the
+ * interpreter. _monitoring.py registers monitoring_callback with
+ * sys.monitoring after configuring the native state through
+ * monitoring_install; the pure-Python handler remains as a fallback.
+ * ============================================================================ */
+
+#if PY_VERSION_HEX >= 0x030C0000
+
+/* Shared matching state: pattern table, co_extra classification
+ * records, window/sweep/frequency evaluation and config parsing. */
+#include "_matching.h"
+
+static bool g_monitoring_installed = false;
+
+/* sys.monitoring.DISABLE, fetched at install time; returned from the
+ * callback for non-matching code objects to stop their events */
+static PyObject *g_monitoring_disable = NULL;
+
+/* sys.monitoring.set_local_events and the LINE event flag, fetched at
+ * install time. Line-scoped patterns never arm LINE events globally;
+ * the PY_START callback arms them per matching code object, so the
+ * interpreter-wide LINE firehose stays off. */
+static PyObject *g_set_local_events = NULL;
+static PyObject *g_line_event = NULL;
+static long g_tool_id = 3;  /* overridden by config['tool_id'] */
+
+/* Enable local LINE events for one code object. Returns 0 on success,
+ * -1 (exception cleared) on failure; the caller then retries on the
+ * next call. */
+static int monitoring_arm_line_events(PyCodeObject *code) {
+    if (g_set_local_events == NULL || g_line_event == NULL) {
+        return -1;
+    }
+    PyObject *result = PyObject_CallFunction(g_set_local_events, "lOO",
+                                             g_tool_id, (PyObject *)code,
+                                             g_line_event);
+    if (result == NULL) {
+        PyErr_Clear();
+        return -1;
+    }
+    Py_DECREF(result);
+    return 0;
+}
+
+PyDoc_STRVAR(py_monitoring_install_doc,
+"monitoring_install(config)\n"
+"\n"
+"Configure the native PEP 669 callback state.\n"
+"\n"
+"Args:\n"
+"    config: A dict with keys:\n"
+"        - targets: List of TargetPattern objects\n"
+"        - delay_ns: Delay in nanoseconds (int)\n"
+"        - delay_mode: 'spin' or 'hybrid' (str, default 'spin')\n"
+"        - delay_dist: 'fixed', 'normal', 'exponential' or 'pareto'\n"
+"          (str, default 'fixed')\n"
+"        - frequency: Trigger every Nth call (int, default 1)\n"
+"        - start_ns: Start time in nanoseconds (int, optional)\n"
+"        - end_ns: End time in nanoseconds (int, optional, 0 = no end)\n"
+"        - sweep: List of (delay_ns, duration_ns) phases stepped\n"
+"          through from start_ns (list, optional)\n"
+"        - threads: List of globs matched against thread names and\n"
+"          idents; only matching threads are bumped (list, optional)\n"
+"        - stretch: Multiplicative slowdown factor; > 1.0 replaces the\n"
+"          fixed entry delay with a return-time delay proportional to\n"
+"          each frame's measured duration (float, optional)\n"
+"\n"
+"The caller is responsible for registering monitoring_callback with\n"
+"sys.monitoring and enabling PY_START events (plus the return and\n"
+"unwind callbacks with PY_RETURN | PY_UNWIND when stretch is set).\n"
+);
+
+static PyObject* py_monitoring_install(PyObject *self, PyObject *args) {
+    (void)self;
+    PyObject *config;
+
+    if (!PyArg_ParseTuple(args, "O!", &PyDict_Type, &config)) {
+        return NULL;
+    }
+
+    if (g_monitoring_installed) {
+        PyErr_SetString(PyExc_RuntimeError, "native monitoring already installed");
+        return NULL;
+    }
+
+    /* Parse the config dict into the shared matching state */
+    if (matching_configure(config) < 0) {
+        return NULL;
+    }
+
+    /* Bumps from the native callback go straight to the stats rings */
+    g_bump_record = stats_record;
+
+    if (g_monitoring_disable == NULL) {
+        PyObject *sys_module = PyImport_ImportModule("sys");
+        if (sys_module == NULL) {
+            return NULL;
+        }
+        PyObject *monitoring = PyObject_GetAttrString(sys_module, "monitoring");
+        Py_DECREF(sys_module);
+        if (monitoring == NULL) {
+            return NULL;
+        }
+        g_monitoring_disable = PyObject_GetAttrString(monitoring, "DISABLE");
+        if (g_monitoring_disable == NULL) {
+            Py_DECREF(monitoring);
+            return NULL;
+        }
+        g_set_local_events = PyObject_GetAttrString(monitoring, "set_local_events");
+        PyObject *events = PyObject_GetAttrString(monitoring, "events");
+        Py_DECREF(monitoring);
+        if (g_set_local_events == NULL || events == NULL) {
+            Py_XDECREF(events);
+            return NULL;
+        }
+        g_line_event = PyObject_GetAttrString(events, "LINE");
+        Py_DECREF(events);
+        if (g_line_event == NULL) {
+            return NULL;
+        }
+    }
+
+    /* The tool ID local LINE events are armed under (the Python side
+     * owns registration and passes its TOOL_ID through the config) */
+    PyObject *tool_id_obj = PyDict_GetItemString(config, "tool_id");
+    if (tool_id_obj != NULL && PyLong_Check(tool_id_obj)) {
+        g_tool_id = PyLong_AsLong(tool_id_obj);
+    }
+
+    g_monitoring_installed = true;
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(py_monitoring_reconfigure_doc,
+"monitoring_reconfigure(config)\n"
+"\n"
+"Atomically swap the native callback configuration in place.\n"
+"\n"
+"Takes the same config dict as monitoring_install. Cached match\n"
+"records are invalidated via the generation counter; the caller must\n"
+"also call sys.monitoring.restart_events() so code objects that\n"
+"previously returned DISABLE fire PY_START events again.\n"
+);
+
+static PyObject* py_monitoring_reconfigure(PyObject *self, PyObject *args) {
+    (void)self;
+    PyObject *config;
+
+    if (!PyArg_ParseTuple(args, "O!", &PyDict_Type, &config)) {
+        return NULL;
+    }
+
+    if (!g_monitoring_installed) {
+        PyErr_SetString(PyExc_RuntimeError, "native monitoring not installed");
+        return NULL;
+    }
+
+    if (matching_configure(config) < 0) {
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(py_monitoring_uninstall_doc,
+"monitoring_uninstall()\n"
+"\n"
+"Drop the native PEP 669 callback state.\n"
+);
+
+static PyObject* py_monitoring_uninstall(PyObject *self, PyObject *args) {
+    (void)self;
+    (void)args;
+
+    if (!g_monitoring_installed) {
+        Py_RETURN_NONE;
+    }
+
+    matching_teardown();
+    g_monitoring_installed = false;
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(py_monitoring_clear_cache_doc,
+"monitoring_clear_cache()\n"
+"\n"
+"Invalidate cached match results.\n"
+"\n"
+"Records cached in code objects' co_extra are generation-tagged;\n"
+"clearing bumps the generation so every code object is reclassified\n"
+"on its next call.\n"
+);
+
+static PyObject* py_monitoring_clear_cache(PyObject *self, PyObject *args) {
+    (void)self;
+    (void)args;
+    matching_clear_cache();
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(py_monitoring_callback_doc,
+"monitoring_callback(code, instruction_offset)\n"
+"\n"
+"PY_START callback. Register with sys.monitoring.register_callback.\n"
+"\n"
+"Returns sys.monitoring.DISABLE for non-matching code objects so\n"
+"their events stop firing; applies the configured delay otherwise.\n"
+);
+
+static PyObject* py_monitoring_callback(PyObject *self, PyObject *const *args,
+                                        Py_ssize_t nargs) {
+    (void)self;
+
+    if (nargs < 1 || !PyCode_Check(args[0])) {
+        Py_RETURN_NONE;
+    }
+
+    /* Thread filter: never DISABLE here - the same code object may be
+     * called from an armed thread later */
+    if (!matching_thread_armed()) {
+        Py_RETURN_NONE;
+    }
+
+    PyCodeObject *code = (PyCodeObject *)args[0];
+
+    CodeExtraRecord local;
+    CodeExtraRecord *record = matching_get_record(code);
+
+    if (record == NULL) {
+        /* 3.12+ has co_qualname; filename is used for module matching,
+         * mirroring the Python handler */
+        const char *module_utf8 = PyUnicode_AsUTF8(code->co_filename);
+        const char *name_utf8 = PyUnicode_AsUTF8(code->co_qualname);
+
+        if (module_utf8 == NULL || name_utf8 == NULL) {
+            PyErr_Clear();
+            Py_RETURN_NONE;
+        }
+
+        record = matching_classify(code, module_utf8, name_utf8, &local);
+    }
+
+    if (!record->match) {
+        /* Disable further PY_START events for this code object */
+        if (g_monitoring_disable != NULL) {
+            Py_INCREF(g_monitoring_disable);
+            return g_monitoring_disable;
+        }
+        Py_RETURN_NONE;
+    }
+
+    if (record->line_start >= 0) {
+        /* Line-scoped match: arm local LINE events for this code
+         * object and disable PY_START - the local events outlive it,
+         * so the steady-state cost sits entirely on the targeted
+         * function's own lines. */
+        if (!record->line_armed && monitoring_arm_line_events(code) == 0) {
+            record->line_armed = true;
+        }
+        if (record->line_armed && g_monitoring_disable != NULL) {
+            Py_INCREF(g_monitoring_disable);
+            return g_monitoring_disable;
+        }
+        Py_RETURN_NONE;
+    }
+
+    if (record->caller_dependent) {
+        /* Resolve the verdict for this call edge. Never DISABLE here:
+         * the same code object may be reached from a matching caller
+         * later. The entered function's frame is the thread's current
+         * frame (the callback itself pushes no Python frame). */
+        PyFrameObject *caller_frame = NULL;
+        PyFrameObject *frame = PyEval_GetFrame();  /* borrowed */
+        if (frame != NULL) {
+            PyCodeObject *frame_code = PyFrame_GetCode(frame);
+            if (frame_code == code) {
+                caller_frame = PyFrame_GetBack(frame);
+            } else {
+                /* Defensive: treat the current frame as the caller */
+                Py_INCREF(frame);
+                caller_frame = frame;
+            }
+            Py_DECREF(frame_code);
+        }
+
+        PyCodeObject *caller_code = NULL;
+        if (caller_frame != NULL) {
+            caller_code = PyFrame_GetCode(caller_frame);
+        }
+
+        CodeExtraRecord edge_local;
+        CodeExtraRecord *edge = matching_find_edge(record, (void *)caller_code);
+        if (edge == NULL) {
+            const char *module_utf8 = PyUnicode_AsUTF8(code->co_filename);
+            const char *name_utf8 = PyUnicode_AsUTF8(code->co_qualname);
+            const char *caller_qualname = NULL;
+            if (caller_code != NULL) {
+                caller_qualname = PyUnicode_AsUTF8(caller_code->co_qualname);
+            }
+            if (module_utf8 == NULL || name_utf8 == NULL) {
+                PyErr_Clear();
+            } else {
+                edge = matching_classify_edge(record, module_utf8, name_utf8,
+                                              (void *)caller_code, caller_qualname,
+                                              &edge_local);
+            }
+            if (caller_qualname == NULL) {
+                PyErr_Clear();
+            }
+        }
+
+        Py_XDECREF(caller_code);
+        Py_XDECREF(caller_frame);
+
+        if (edge != NULL && edge->match) {
+            if (matching_stretch_active()) {
+                matching_stretch_enter(code);
+            } else {
+                matching_bump(code, edge);
+            }
+        }
+        Py_RETURN_NONE;
+    }
+
+    if (matching_stretch_active()) {
+        matching_stretch_enter(code);
+    } else {
+        matching_bump(code, record);
+    }
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(py_monitoring_line_callback_doc,
+"monitoring_line_callback(code, line_number)\n"
+"\n"
+"LINE callback for line-scoped patterns. _monitoring.py registers it\n"
+"when any pattern carries a line range; LINE events are only ever\n"
+"armed locally, per matching code object, by the PY_START callback.\n"
+"\n"
+"Lines inside the pattern's range go through the usual window, sweep\n"
+"and frequency gates and are delayed; lines outside it return\n"
+"sys.monitoring.DISABLE, which the interpreter records per line, so\n"
+"each out-of-range line fires exactly once per configuration.\n"
+);
+
+static PyObject* py_monitoring_line_callback(PyObject *self, PyObject *const *args,
+                                             Py_ssize_t nargs) {
+    (void)self;
+
+    if (nargs < 2 || !PyCode_Check(args[0])) {
+        Py_RETURN_NONE;
+    }
+
+    if (!matching_thread_armed()) {
+        Py_RETURN_NONE;
+    }
+
+    PyCodeObject *code = (PyCodeObject *)args[0];
+    long line_number = PyLong_AsLong(args[1]);
+    if (line_number == -1 && PyErr_Occurred()) {
+        PyErr_Clear();
+        Py_RETURN_NONE;
+    }
+
+    CodeExtraRecord local;
+    CodeExtraRecord *record = matching_get_record(code);
+
+    if (record == NULL) {
+        const char *module_utf8 = PyUnicode_AsUTF8(code->co_filename);
+        const char *name_utf8 = PyUnicode_AsUTF8(code->co_qualname);
+
+        if (module_utf8 == NULL || name_utf8 == NULL) {
+            PyErr_Clear();
+            Py_RETURN_NONE;
+        }
+
+        record = matching_classify(code, module_utf8, name_utf8, &local);
+    }
+
+    if (!record->match || record->line_start < 0 ||
+        line_number < record->line_start || line_number > record->line_end) {
+        /* Non-matching or out-of-range: per-line DISABLE leaves the
+         * in-range lines as the only ones still firing */
+        if (g_monitoring_disable != NULL) {
+            Py_INCREF(g_monitoring_disable);
+            return g_monitoring_disable;
+        }
+        Py_RETURN_NONE;
+    }
+
+    matching_bump(code, record);
+    Py_RETURN_NONE;
+}
+
+/* Common tail of the PY_RETURN and PY_UNWIND callbacks: classify the
+ * exiting code object and, for matches, pop its side-stack entry and
+ * inject the proportional delay. Returns true for matches (the unwind
+ * callback must not DISABLE, so the verdict is the caller's to act on).
+ *
+ * Caller-dependent code objects share the side-stack: only edges that
+ * matched on entry pushed a frame, so a failed pop is the non-matching
+ * edge's exit and nothing happens. */
+static bool monitoring_stretch_exit(PyCodeObject *code) {
+    CodeExtraRecord local;
+    CodeExtraRecord *record = matching_get_record(code);
+
+    if (record == NULL) {
+        const char *module_utf8 = PyUnicode_AsUTF8(code->co_filename);
+        const char *name_utf8 = PyUnicode_AsUTF8(code->co_qualname);
+
+        if (module_utf8 == NULL || name_utf8 == NULL) {
+            PyErr_Clear();
+            return true;  /* Unknown; do not DISABLE */
+        }
+
+        record = matching_classify(code, module_utf8, name_utf8, &local);
+    }
+
+    if (!record->match) {
+        return false;
+    }
+
+    if (matching_stretch_active()) {
+        matching_stretch_return(code, record);
+    }
+    return true;
+}
+
+PyDoc_STRVAR(py_monitoring_return_callback_doc,
+"monitoring_return_callback(code, instruction_offset, retval)\n"
+"\n"
+"PY_RETURN callback for stretch mode. _monitoring.py registers it\n"
+"(and enables PY_RETURN events) only when a stretch factor is\n"
+"configured.\n"
+"\n"
+"Pops the frame's entry timestamp from the per-thread side-stack and\n"
+"delays in proportion to its measured duration. Returns\n"
+"sys.monitoring.DISABLE for non-matching code objects.\n"
+);
+
+static PyObject* py_monitoring_return_callback(PyObject *self, PyObject *const *args,
+                                               Py_ssize_t nargs) {
+    (void)self;
+
+    if (nargs < 1 || !PyCode_Check(args[0])) {
+        Py_RETURN_NONE;
+    }
+
+    if (!matching_thread_armed()) {
+        Py_RETURN_NONE;
+    }
+
+    if (!monitoring_stretch_exit((PyCodeObject *)args[0])) {
+        if (g_monitoring_disable != NULL) {
+            Py_INCREF(g_monitoring_disable);
+            return g_monitoring_disable;
+        }
+    }
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(py_monitoring_unwind_callback_doc,
+"monitoring_unwind_callback(code, instruction_offset, exception)\n"
+"\n"
+"PY_UNWIND callback for stretch mode: frames that exit via an\n"
+"exception fire PY_UNWIND instead of PY_RETURN, and their side-stack\n"
+"entries must still be popped (and stretched) or the pairing would\n"
+"leak. PY_UNWIND cannot be disabled per code object, so this never\n"
+"returns DISABLE.\n"
+);
+
+static PyObject* py_monitoring_unwind_callback(PyObject *self, PyObject *const *args,
+                                               Py_ssize_t nargs) {
+    (void)self;
+
+    if (nargs < 1 || !PyCode_Check(args[0])) {
+        Py_RETURN_NONE;
+    }
+
+    if (!matching_thread_armed()) {
+        Py_RETURN_NONE;
+    }
+
+    monitoring_stretch_exit((PyCodeObject *)args[0]);
+    Py_RETURN_NONE;
+}
+
+#endif /* PY_VERSION_HEX >= 0x030C0000 */
+
 /* ============================================================================
  * Module Definition
  * ============================================================================ */
 
 static PyMethodDef module_methods[] = {
     {"spin_delay_ns", py_spin_delay_ns, METH_VARARGS, py_spin_delay_ns_doc},
+    {"apply_delay_ns", py_apply_delay_ns, METH_VARARGS, py_apply_delay_ns_doc},
+    {"set_delay_mode", py_set_delay_mode, METH_VARARGS, py_set_delay_mode_doc},
+    {"get_delay_mode", py_get_delay_mode, METH_NOARGS, py_get_delay_mode_doc},
+    {"set_delay_dist", py_set_delay_dist, METH_VARARGS, py_set_delay_dist_doc},
+    {"get_delay_dist", py_get_delay_dist, METH_NOARGS, py_get_delay_dist_doc},
     {"get_clock_overhead_ns", py_get_clock_overhead_ns, METH_NOARGS,
      py_get_clock_overhead_ns_doc},
     {"get_min_delay_ns", py_get_min_delay_ns, METH_NOARGS, py_get_min_delay_ns_doc},
+    {"get_timer_overhead_ns", py_get_timer_overhead_ns, METH_NOARGS,
+     py_get_timer_overhead_ns_doc},
+    {"get_bump_overhead_ns", py_get_bump_overhead_ns, METH_NOARGS,
+     py_get_bump_overhead_ns_doc},
+    {"get_callback_overhead_ns", py_get_callback_overhead_ns, METH_NOARGS,
+     py_get_callback_overhead_ns_doc},
+    {"set_callback_overhead_ns", py_set_callback_overhead_ns, METH_VARARGS,
+     py_set_callback_overhead_ns_doc},
+    {"get_timer_backend", py_get_timer_backend, METH_NOARGS, py_get_timer_backend_doc},
     {"is_calibrated", py_is_calibrated, METH_NOARGS, py_is_calibrated_doc},
+    {"recalibrate", py_recalibrate, METH_NOARGS, py_recalibrate_doc},
+    {"stats_start", py_stats_start, METH_VARARGS, py_stats_start_doc},
+    {"stats_stop", py_stats_stop, METH_NOARGS, py_stats_stop_doc},
+    {"stats_is_enabled", py_stats_is_enabled, METH_NOARGS, py_stats_is_enabled_doc},
+    {"stats_dropped", py_stats_dropped, METH_NOARGS, py_stats_dropped_doc},
+    {"stats_record", py_stats_record, METH_VARARGS, py_stats_record_doc},
+    {"stats_fork_reset", py_stats_fork_reset, METH_NOARGS, py_stats_fork_reset_doc},
+    {"mark", (PyCFunction)(void (*)(void))py_mark, METH_FASTCALL, py_mark_doc},
+#if PY_VERSION_HEX >= 0x030C0000
+    {"monitoring_install", py_monitoring_install, METH_VARARGS,
+     py_monitoring_install_doc},
+    {"monitoring_reconfigure", py_monitoring_reconfigure, METH_VARARGS,
+     py_monitoring_reconfigure_doc},
+    {"monitoring_uninstall", py_monitoring_uninstall, METH_NOARGS,
+     py_monitoring_uninstall_doc},
+    {"monitoring_clear_cache", py_monitoring_clear_cache, METH_NOARGS,
+     py_monitoring_clear_cache_doc},
+    {"monitoring_callback", (PyCFunction)(void (*)(void))py_monitoring_callback,
+     METH_FASTCALL, py_monitoring_callback_doc},
+    {"monitoring_return_callback",
+     (PyCFunction)(void (*)(void))py_monitoring_return_callback,
+     METH_FASTCALL, py_monitoring_return_callback_doc},
+    {"monitoring_unwind_callback",
+     (PyCFunction)(void (*)(void))py_monitoring_unwind_callback,
+     METH_FASTCALL, py_monitoring_unwind_callback_doc},
+    {"monitoring_line_callback",
+     (PyCFunction)(void (*)(void))py_monitoring_line_callback,
+     METH_FASTCALL, py_monitoring_line_callback_doc},
+#endif
     {NULL, NULL, 0, NULL}
 };
 
@@ -211,6 +1124,16 @@ static int module_exec(PyObject *module) {
         return -1;
     }
 
+    /* Export the stats recording API for _setprofile */
+    PyObject *capsule = PyCapsule_New(&g_stats_capsule_api, STATS_API_CAPSULE_NAME, NULL);
+    if (capsule == NULL) {
+        return -1;
+    }
+    if (PyModule_AddObject(module, "_STATS_API", capsule) < 0) {
+        Py_DECREF(capsule);
+        return -1;
+    }
+
     return 0;
 }
 
@@ -0,0 +1,1472 @@
+/*
+ * Speed Bump - Shared target matching and bump dispatch
+ *
+ * The native state both monitoring backends need: the compiled pattern
+ * table, per-code-object classification records cached via co_extra,
+ * the timing window, the sweep schedule, the thread filter and the
+ * frequency counters.
+ * _setprofile.c (sys.setprofile, Python 3.10/3.11) and _core.c's PEP 669
+ * callback (Python 3.12+) both include this header; as with _timing.h,
+ * all state is static so each translation unit carries its own copy and
+ * only one backend is ever active in a process.
+ *
+ * Include after Python.h and _timing.h.
+ *
+ * Cached records carry a generation number. Reconfiguring or clearing
+ * the cache bumps the generation, so stale records are reclassified on
+ * their next call instead of requiring co_extra to be scrubbed.
+ */
+
+#ifndef SPEED_BUMP_MATCHING_H
+#define SPEED_BUMP_MATCHING_H
+
+#include <fnmatch.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+/* co_extra moved behind PyUnstable_ names in 3.12 */
+#if PY_VERSION_HEX >= 0x030C0000
+#define SB_RequestCodeExtraIndex PyUnstable_Eval_RequestCodeExtraIndex
+#define SB_Code_GetExtra PyUnstable_Code_GetExtra
+#define SB_Code_SetExtra PyUnstable_Code_SetExtra
+#else
+#define SB_RequestCodeExtraIndex _PyEval_RequestCodeExtraIndex
+#define SB_Code_GetExtra _PyCode_GetExtra
+#define SB_Code_SetExtra _PyCode_SetExtra
+#endif
+
+/* ============================================================================
+ * State
+ * ============================================================================ */
+
+/* Index for storing classification records in code objects' co_extra */
+static Py_ssize_t g_extra_index = -1;
+
+/* Original TargetPattern list, kept for introspection */
+static PyObject *g_target_patterns = NULL;
+
+/* Native compiled patterns.
+ *
+ * The glob strings are copied out of the TargetPattern objects at
+ * configure time so the uncached classification path never calls back
+ * into Python. Matching uses libc fnmatch(3), which has the same *, ?
+ * and [seq] semantics as Python's fnmatch module on POSIX. */
+typedef struct {
+    char *module_glob;
+    char *name_glob;
+    char *caller_glob;  /* caller qualname constraint, NULL = any caller */
+    int64_t delay_ns;   /* per-pattern override, -1 = use global default */
+    int64_t frequency;  /* per-pattern override, -1 = use global default */
+    int64_t line_start; /* line scope start, -1 = whole function */
+    int64_t line_end;   /* line scope end (inclusive), -1 = whole function */
+    int64_t rate_interval_ns;  /* ns per token bucket refill, -1 = use default */
+} CompiledPattern;
+
+/* The pattern table is published as a single pointer so readers always
+ * see a consistent (patterns, count) pair, and superseded tables are
+ * retired to a list instead of freed in place: on free-threaded builds
+ * the callbacks run without the GIL, so a reconfiguring thread cannot
+ * know when the last reader has left the old table. Retired tables are
+ * freed at teardown, once the callbacks are uninstalled - the same
+ * never-invalidate-under-a-reader approach the Python fallback takes
+ * by replacing its cache dicts wholesale. The chain grows by one entry
+ * per reconfigure, which live-control usage keeps small. */
+typedef struct PatternTable {
+    CompiledPattern *patterns;
+    Py_ssize_t count;
+    struct PatternTable *retired;  /* chain of superseded tables */
+} PatternTable;
+
+static _Atomic(PatternTable *) g_pattern_table = NULL;
+static PatternTable *g_retired_tables = NULL;  /* mutated under the GIL */
+
+/* Stats recording hook, set by the including backend: _core wires it to
+ * its stats ring directly, _setprofile to the API imported from _core's
+ * capsule. NULL skips recording. */
+static void (*g_bump_record)(uint64_t code_id, uint64_t delay_ns) = NULL;
+
+/* Configuration. The scalar defaults are atomics because a live
+ * reconfigure rewrites them while GIL-free callbacks read them when
+ * classifying; relaxed suffices - each field is meaningful alone and a
+ * mixed snapshot only mislabels the record the generation bump is
+ * about to invalidate anyway. */
+static _Atomic uint64_t g_delay_ns = 0;
+static _Atomic int g_frequency = 1;
+static _Atomic int64_t g_rate_interval_ns = 0;  /* ns per bump under the rate cap, 0 = off */
+/* Window bounds are atomics because the scheduler thread reads them
+ * without the GIL while configure rewrites them; relaxed suffices - the
+ * thread re-evaluates every tick and each field is meaningful alone. */
+static _Atomic int64_t g_start_ns = 0;
+static _Atomic int64_t g_end_ns = 0;  /* 0 = no end time */
+
+/* Timing window scheduler. Rather than reading CLOCK_REALTIME on every
+ * matching call to evaluate the window (a syscall-adjacent cost, and
+ * wrong across NTP steps), a background timer thread flips this armed
+ * flag at window boundaries - including the optional periodic duty
+ * cycle, an on/off square wave repeating from g_start_ns - and the hot
+ * path reads one relaxed atomic. With no window configured the flag is
+ * pinned true and no thread runs. */
+static _Atomic bool g_window_armed = true;
+static _Atomic int64_t g_window_on_ns = 0;  /* duty-cycle on phase, 0 = no cycle */
+static _Atomic int64_t g_window_off_ns = 0;
+static pthread_t g_window_thread;
+static _Atomic bool g_window_thread_running = false;
+
+/* Sweep schedule: phases of (delay, absolute end time) stepped through
+ * in order from g_start_ns. While a phase is active its delay replaces
+ * g_delay_ns; after the last phase no further delays are applied. The
+ * index starts at -1 ("not yet entered") and only ever advances.
+ * Published and retired like the pattern table, so a reconfigure never
+ * frees arrays a concurrent callback is still reading. */
+typedef struct SweepSchedule {
+    uint64_t *delays;
+    int64_t *ends;
+    Py_ssize_t len;
+    _Atomic Py_ssize_t index;
+    struct SweepSchedule *retired;  /* chain of superseded schedules */
+} SweepSchedule;
+
+static _Atomic(SweepSchedule *) g_sweep_schedule = NULL;
+static SweepSchedule *g_retired_sweeps = NULL;  /* mutated under the GIL */
+
+/* code_id used for phase marker stats records (matches
+ * speed_bump.stats.PHASE_MARKER_ID; no real code object has id 0) */
+#define PHASE_MARKER_ID 0
+
+/* Thread filter globs (SPEED_BUMP_THREADS), matched against the thread
+ * name and ident. NULL = all threads armed. Published and retired like
+ * the pattern table, so a live reconfigure never frees globs a
+ * concurrent callback is still matching against. */
+typedef struct ThreadFilter {
+    char **globs;
+    Py_ssize_t count;
+    struct ThreadFilter *retired;  /* chain of superseded filters */
+} ThreadFilter;
+
+static _Atomic(ThreadFilter *) g_thread_filter = NULL;
+static ThreadFilter *g_retired_filters = NULL;  /* mutated under the GIL */
+
+/* Per-thread armed flag, evaluated lazily against the filter on each
+ * thread's first callback and cached until the generation changes, so
+ * non-targeted threads pay one TLS read per call and nothing else. */
+static __thread uint64_t t_thread_generation = 0;
+static __thread bool t_thread_armed = true;
+
+/* Stretch factor (SPEED_BUMP_STRETCH). When > 1.0, matching functions
+ * are delayed on return in proportion to their own measured duration -
+ * 1.5 makes them 50% slower - instead of by the fixed delay on entry.
+ * 0 disables stretch mode. */
+static _Atomic double g_stretch = 0.0;
+
+/* Cache generation. Records from older generations are reclassified.
+ * Atomic for the same reason as the config scalars above. */
+static _Atomic uint64_t g_match_generation = 0;
+
+/* Per-code-object classification record stored via co_extra.
+ *
+ * Carries the match verdict together with the resolved per-pattern
+ * (delay, frequency) and the call counter the frequency gate bumps, so
+ * matching calls never re-consult the pattern table and never touch the
+ * heap. Records are malloc'd once per classified code object; the
+ * freefunc registered with the extra index retires them (co_extra runs
+ * it on a replaced record when a stale one is overwritten, possibly
+ * while a GIL-free callback still reads the old one). */
+struct EdgeRecord;
+
+typedef struct CodeExtraRecord {
+    uint64_t generation;
+    bool match;
+    bool caller_dependent;  /* verdict depends on the calling function */
+    bool heap;  /* record is malloc'd and cached (edges may attach) */
+    bool has_delay_override;  /* pattern carried its own delay_ns= */
+    uint64_t delay_ns;  /* pattern override, or global default snapshot */
+    int64_t frequency;  /* resolved: pattern override or global default */
+    _Atomic uint64_t call_count;  /* calls seen, for the frequency gate */
+    int64_t line_start;  /* pattern's line scope, -1 = whole function */
+    int64_t line_end;    /* inclusive */
+    bool line_armed;  /* local LINE events enabled for this code object */
+    int64_t rate_interval_ns;  /* resolved rate cap; 0 = frequency gating */
+    _Atomic int64_t rate_tat_ns;  /* token bucket state (GCRA arrival time) */
+    PyObject *qualname;  /* owned interned qualified name, memoized by the
+                          * 3.10 backend (co_qualname is missing there and
+                          * deriving the name needs a live frame); NULL when
+                          * the backend gets the name for free */
+    _Atomic(struct EdgeRecord *) edges;  /* per-caller verdicts
+                                          * (caller-dependent only) */
+    struct CodeExtraRecord *retired_next;  /* chain of superseded records */
+} CodeExtraRecord;
+
+/* Per-edge verdict for a caller-dependent code object, keyed by the
+ * calling code object's identity (like the id()-keyed caches on the
+ * Python side; code objects are long-lived). Hangs off the callee's
+ * record as a linked list - the set of distinct callers per callee is
+ * small in practice - so the pattern walk happens once per (caller,
+ * callee) pair rather than once per call. */
+typedef struct EdgeRecord {
+    void *caller_code;
+    struct EdgeRecord *next;
+    CodeExtraRecord rec;
+} EdgeRecord;
+
+/* Superseded records. SB_Code_SetExtra runs the freefunc on a replaced
+ * record immediately, but without the GIL another callback thread may
+ * still be using it - bumping call_count, walking its edge list - so
+ * the freefunc retires records onto this chain instead of freeing
+ * them; the chain is reclaimed at teardown, once the callbacks are
+ * uninstalled (the same swap-and-defer the pattern table uses). Retired
+ * records are small and reconfigures are rare, so the chain stays
+ * short. */
+static _Atomic(CodeExtraRecord *) g_retired_records = NULL;
+
+/* Reclaim one record: its edge list and its memoized qualified name. */
+static void free_record(CodeExtraRecord *record) {
+    EdgeRecord *edge = atomic_load_explicit(&record->edges, memory_order_relaxed);
+    while (edge != NULL) {
+        EdgeRecord *next = edge->next;
+        free(edge);
+        edge = next;
+    }
+    Py_XDECREF(record->qualname);
+    free(record);
+}
+
+/* co_extra freefunc: runs when a stale record is overwritten after a
+ * reconfigure and when its code object is deallocated. Replacement can
+ * race a GIL-free reader, so push onto the retired chain (CAS - two
+ * classifiers can retire concurrently) rather than freeing. */
+static void matching_retire_record(void *extra) {
+    CodeExtraRecord *record = (CodeExtraRecord *)extra;
+    CodeExtraRecord *head = atomic_load_explicit(&g_retired_records,
+                                                 memory_order_relaxed);
+    do {
+        record->retired_next = head;
+    } while (!atomic_compare_exchange_weak_explicit(&g_retired_records,
+                                                    &head, record,
+                                                    memory_order_release,
+                                                    memory_order_relaxed));
+}
+
+/* Free every retired record. Only safe once the callbacks are
+ * uninstalled (teardown), when no reader can hold one. */
+static void free_retired_records(void) {
+    CodeExtraRecord *record = atomic_exchange_explicit(&g_retired_records, NULL,
+                                                       memory_order_acquire);
+    while (record != NULL) {
+        CodeExtraRecord *next = record->retired_next;
+        free_record(record);
+        record = next;
+    }
+}
+
+/* ============================================================================
+ * Time Utilities
+ * ============================================================================ */
+
+static inline int64_t get_time_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)timespec_to_ns(&ts);
+}
+
+/* ============================================================================
+ * Window Scheduler
+ * ============================================================================ */
+
+/* Evaluate the window at now_ns, setting *next_ns to the next boundary
+ * where the armed verdict can change (capped at 100ms so configuration
+ * changes and clock steps are picked up promptly). */
+static bool window_evaluate(int64_t now_ns, int64_t *next_ns) {
+    /* Snapshot the config once per evaluation: the scheduler thread
+     * runs without the GIL, so these can change under it mid-call */
+    int64_t start_ns = atomic_load_explicit(&g_start_ns, memory_order_relaxed);
+    int64_t end_ns = atomic_load_explicit(&g_end_ns, memory_order_relaxed);
+    int64_t on_ns = atomic_load_explicit(&g_window_on_ns, memory_order_relaxed);
+    int64_t off_ns = atomic_load_explicit(&g_window_off_ns, memory_order_relaxed);
+
+    int64_t next = now_ns + 100000000LL;
+    bool armed = true;
+
+    if (now_ns < start_ns) {
+        armed = false;
+        if (start_ns < next) {
+            next = start_ns;
+        }
+    } else if (end_ns > 0 && now_ns >= end_ns) {
+        armed = false;  /* Over; no boundary left to wait for */
+    } else {
+        if (end_ns > 0 && end_ns < next) {
+            next = end_ns;
+        }
+        if (on_ns > 0) {
+            int64_t period = on_ns + off_ns;
+            int64_t offset = (now_ns - start_ns) % period;
+            int64_t boundary;
+            if (offset < on_ns) {
+                boundary = now_ns - offset + on_ns;
+            } else {
+                armed = false;
+                boundary = now_ns - offset + period;
+            }
+            if (boundary < next) {
+                next = boundary;
+            }
+        }
+    }
+
+    *next_ns = next;
+    return armed;
+}
+
+static void* window_thread_main(void *arg) {
+    (void)arg;
+    while (atomic_load_explicit(&g_window_thread_running, memory_order_acquire)) {
+        int64_t next_ns;
+        int64_t now_ns = get_time_ns();
+        bool armed = window_evaluate(now_ns, &next_ns);
+        atomic_store_explicit(&g_window_armed, armed, memory_order_relaxed);
+
+        int64_t sleep_ns = next_ns - now_ns;
+        if (sleep_ns < 1000000LL) {
+            sleep_ns = 1000000LL;  /* Floor 1ms: never spin on a boundary */
+        }
+        struct timespec ts = {
+            .tv_sec = sleep_ns / 1000000000LL,
+            .tv_nsec = sleep_ns % 1000000000LL,
+        };
+        nanosleep(&ts, NULL);
+    }
+    return NULL;
+}
+
+/* Start or stop the scheduler to match the current window config, and
+ * store the armed verdict synchronously so the window applies before
+ * the thread's first tick. Runs under the GIL (configure/teardown);
+ * the thread re-reads the globals fresh on every wake, so a racing
+ * evaluation is stale for at most one 100ms tick. */
+static void window_scheduler_update(void) {
+    bool needed =
+        atomic_load_explicit(&g_start_ns, memory_order_relaxed) > 0 ||
+        atomic_load_explicit(&g_end_ns, memory_order_relaxed) > 0 ||
+        atomic_load_explicit(&g_window_on_ns, memory_order_relaxed) > 0;
+
+    if (!needed) {
+        if (atomic_load_explicit(&g_window_thread_running, memory_order_relaxed)) {
+            atomic_store_explicit(&g_window_thread_running, false,
+                                  memory_order_release);
+            pthread_join(g_window_thread, NULL);
+        }
+        atomic_store_explicit(&g_window_armed, true, memory_order_relaxed);
+        return;
+    }
+
+    int64_t next_ns;
+    bool armed = window_evaluate(get_time_ns(), &next_ns);
+    atomic_store_explicit(&g_window_armed, armed, memory_order_relaxed);
+
+    if (!atomic_load_explicit(&g_window_thread_running, memory_order_relaxed)) {
+        atomic_store_explicit(&g_window_thread_running, true, memory_order_release);
+        if (pthread_create(&g_window_thread, NULL, window_thread_main, NULL) != 0) {
+            /* No thread: keep the synchronous verdict; it refreshes on
+             * the next reconfigure */
+            atomic_store_explicit(&g_window_thread_running, false,
+                                  memory_order_relaxed);
+        }
+    }
+}
+
+/* ============================================================================
+ * Pattern Table
+ * ============================================================================ */
+
+static void free_pattern_table(PatternTable *table) {
+    if (table == NULL) {
+        return;
+    }
+    for (Py_ssize_t i = 0; i < table->count; i++) {
+        free(table->patterns[i].module_glob);
+        free(table->patterns[i].name_glob);
+        free(table->patterns[i].caller_glob);
+    }
+    free(table->patterns);
+    free(table);
+}
+
+/* Swap in a new pattern table (NULL = no patterns) and retire the old
+ * one; callbacks still walking the old table keep a valid snapshot. */
+static void publish_pattern_table(PatternTable *table) {
+    PatternTable *old = atomic_exchange_explicit(&g_pattern_table, table,
+                                                 memory_order_acq_rel);
+    if (old != NULL) {
+        old->retired = g_retired_tables;
+        g_retired_tables = old;
+    }
+}
+
+/* Free every retired table. Only safe once the callbacks are
+ * uninstalled (teardown), when no reader can hold a snapshot. */
+static void free_retired_pattern_tables(void) {
+    PatternTable *table = g_retired_tables;
+    while (table != NULL) {
+        PatternTable *next = table->retired;
+        free_pattern_table(table);
+        table = next;
+    }
+    g_retired_tables = NULL;
+}
+
+/* Copy one glob attribute out of a TargetPattern into a malloc'd C string.
+ * Returns NULL with an exception set on failure. */
+static char* copy_glob_attr(PyObject *pattern, const char *attr_name) {
+    PyObject *attr = PyObject_GetAttrString(pattern, attr_name);
+    if (attr == NULL) {
+        return NULL;
+    }
+
+    const char *utf8 = PyUnicode_AsUTF8(attr);
+    if (utf8 == NULL) {
+        Py_DECREF(attr);
+        return NULL;
+    }
+
+    char *copy = strdup(utf8);
+    Py_DECREF(attr);
+    if (copy == NULL) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    return copy;
+}
+
+/* Copy an optional glob attribute (caller_pattern) into a malloc'd C
+ * string; None becomes NULL ("no constraint"). Returns 0 on success,
+ * -1 with an exception set on failure. */
+static int copy_optional_glob_attr(PyObject *pattern, const char *attr_name, char **out) {
+    PyObject *attr = PyObject_GetAttrString(pattern, attr_name);
+    if (attr == NULL) {
+        return -1;
+    }
+
+    if (attr == Py_None) {
+        *out = NULL;
+        Py_DECREF(attr);
+        return 0;
+    }
+
+    const char *utf8 = PyUnicode_AsUTF8(attr);
+    if (utf8 == NULL) {
+        Py_DECREF(attr);
+        return -1;
+    }
+
+    *out = strdup(utf8);
+    Py_DECREF(attr);
+    if (*out == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    return 0;
+}
+
+/* Read an optional integer override attribute (delay_ns / frequency)
+ * from a TargetPattern; None becomes -1 ("use the global default").
+ * Returns 0 on success, -1 with an exception set on failure. */
+static int read_override_attr(PyObject *pattern, const char *attr_name, int64_t *out) {
+    PyObject *attr = PyObject_GetAttrString(pattern, attr_name);
+    if (attr == NULL) {
+        return -1;
+    }
+
+    if (attr == Py_None) {
+        *out = -1;
+        Py_DECREF(attr);
+        return 0;
+    }
+
+    *out = PyLong_AsLongLong(attr);
+    Py_DECREF(attr);
+    if (*out == -1 && PyErr_Occurred()) {
+        return -1;
+    }
+    return 0;
+}
+
+/* Read the optional per-pattern rate (bumps/second, float) and store
+ * it as the token bucket's refill interval in ns; None becomes -1
+ * ("use the global default"). Returns 0 on success, -1 with an
+ * exception set on failure. */
+static int read_rate_attr(PyObject *pattern, int64_t *out) {
+    PyObject *attr = PyObject_GetAttrString(pattern, "rate");
+    if (attr == NULL) {
+        return -1;
+    }
+
+    if (attr == Py_None) {
+        *out = -1;
+        Py_DECREF(attr);
+        return 0;
+    }
+
+    double rate = PyFloat_AsDouble(attr);
+    Py_DECREF(attr);
+    if (rate == -1.0 && PyErr_Occurred()) {
+        return -1;
+    }
+    *out = rate > 0.0 ? (int64_t)(1e9 / rate) : -1;
+    return 0;
+}
+
+/* Build and publish the native pattern table from a list of
+ * TargetPattern objects, retiring the previous table. Returns 0 on
+ * success, -1 with an exception set on failure (the previous table
+ * stays published). */
+static int compile_target_patterns(PyObject *targets) {
+    Py_ssize_t count = PyList_GET_SIZE(targets);
+    if (count == 0) {
+        publish_pattern_table(NULL);
+        return 0;
+    }
+
+    PatternTable *table = calloc(1, sizeof(PatternTable));
+    if (table == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    table->patterns = calloc((size_t)count, sizeof(CompiledPattern));
+    if (table->patterns == NULL) {
+        free(table);
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    for (Py_ssize_t i = 0; i < count; i++) {
+        PyObject *pattern = PyList_GET_ITEM(targets, i);
+        CompiledPattern *compiled = &table->patterns[i];
+
+        compiled->module_glob = copy_glob_attr(pattern, "module_pattern");
+        if (compiled->module_glob == NULL) {
+            table->count = i;
+            free_pattern_table(table);
+            return -1;
+        }
+
+        compiled->name_glob = copy_glob_attr(pattern, "name_pattern");
+        if (compiled->name_glob == NULL) {
+            free(compiled->module_glob);
+            compiled->module_glob = NULL;
+            table->count = i;
+            free_pattern_table(table);
+            return -1;
+        }
+
+        if (copy_optional_glob_attr(pattern, "caller_pattern",
+                                    &compiled->caller_glob) < 0 ||
+            read_override_attr(pattern, "delay_ns", &compiled->delay_ns) < 0 ||
+            read_override_attr(pattern, "frequency", &compiled->frequency) < 0 ||
+            read_override_attr(pattern, "line_start", &compiled->line_start) < 0 ||
+            read_override_attr(pattern, "line_end", &compiled->line_end) < 0 ||
+            read_rate_attr(pattern, &compiled->rate_interval_ns) < 0) {
+            table->count = i + 1;
+            free_pattern_table(table);
+            return -1;
+        }
+    }
+
+    table->count = count;
+    publish_pattern_table(table);
+    return 0;
+}
+
+/* Find the first matching pattern in a table snapshot, ignoring caller
+ * constraints (a caller-qualified pattern is a potential match for its
+ * code object). Returns its index, or -1 for no match. */
+static Py_ssize_t find_pattern_match(const PatternTable *table,
+                                     const char *module_name,
+                                     const char *qualified_name) {
+    if (table == NULL) {
+        return -1;
+    }
+    for (Py_ssize_t i = 0; i < table->count; i++) {
+        if (fnmatch(table->patterns[i].module_glob, module_name, 0) == 0 &&
+            fnmatch(table->patterns[i].name_glob, qualified_name, 0) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* Find the first pattern in a table snapshot matching a specific call
+ * edge: like find_pattern_match, but caller-qualified patterns only
+ * match when the calling function's qualified name satisfies their
+ * glob. caller_qualname may be NULL (no Python caller). */
+static Py_ssize_t find_edge_pattern_match(const PatternTable *table,
+                                          const char *module_name,
+                                          const char *qualified_name,
+                                          const char *caller_qualname) {
+    if (table == NULL) {
+        return -1;
+    }
+    for (Py_ssize_t i = 0; i < table->count; i++) {
+        CompiledPattern *pattern = &table->patterns[i];
+        if (fnmatch(pattern->module_glob, module_name, 0) != 0 ||
+            fnmatch(pattern->name_glob, qualified_name, 0) != 0) {
+            continue;
+        }
+        if (pattern->caller_glob == NULL) {
+            return i;
+        }
+        if (caller_qualname != NULL &&
+            fnmatch(pattern->caller_glob, caller_qualname, 0) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* ============================================================================
+ * Sweep Schedule
+ * ============================================================================ */
+
+/* Current sweep phase delay for now_ns, advancing past phases whose end
+ * times have passed. Each boundary is recorded into the stats stream as
+ * a phase marker so the output can be segmented per phase. Returns
+ * false once the sweep is exhausted (no further delays apply).
+ *
+ * Callbacks can race here without the GIL, so the index is read into a
+ * local snapshot (never re-indexed into the arrays after a check) and
+ * advanced with a CAS; the winning thread records the phase marker, so
+ * each boundary is marked exactly once. */
+static bool sweep_current_delay(SweepSchedule *sweep, int64_t now_ns,
+                                uint64_t *delay_out) {
+    Py_ssize_t index = atomic_load_explicit(&sweep->index, memory_order_relaxed);
+    while (index < sweep->len) {
+        if (index >= 0 && now_ns < sweep->ends[index]) {
+            *delay_out = sweep->delays[index];
+            return true;
+        }
+        if (atomic_compare_exchange_weak_explicit(&sweep->index, &index, index + 1,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+            index++;
+            if (index < sweep->len && g_bump_record != NULL) {
+                g_bump_record(PHASE_MARKER_ID, sweep->delays[index]);
+            }
+        }
+        /* On failure the CAS reloaded index; re-evaluate from there */
+    }
+    return false;
+}
+
+static void free_sweep_schedule(SweepSchedule *sweep) {
+    if (sweep == NULL) {
+        return;
+    }
+    free(sweep->delays);
+    free(sweep->ends);
+    free(sweep);
+}
+
+/* Swap in a new sweep schedule (NULL = no sweep) and retire the old
+ * one; callbacks mid-lookup keep a valid snapshot. */
+static void publish_sweep_schedule(SweepSchedule *sweep) {
+    SweepSchedule *old = atomic_exchange_explicit(&g_sweep_schedule, sweep,
+                                                  memory_order_acq_rel);
+    if (old != NULL) {
+        old->retired = g_retired_sweeps;
+        g_retired_sweeps = old;
+    }
+}
+
+/* Free every retired schedule. Only safe once the callbacks are
+ * uninstalled (teardown), when no reader can hold a snapshot. */
+static void free_retired_sweep_schedules(void) {
+    SweepSchedule *sweep = g_retired_sweeps;
+    while (sweep != NULL) {
+        SweepSchedule *next = sweep->retired;
+        free_sweep_schedule(sweep);
+        sweep = next;
+    }
+    g_retired_sweeps = NULL;
+}
+
+/* ============================================================================
+ * Thread Filter
+ * ============================================================================ */
+
+static void free_thread_filter(ThreadFilter *filter) {
+    if (filter == NULL) {
+        return;
+    }
+    for (Py_ssize_t i = 0; i < filter->count; i++) {
+        free(filter->globs[i]);
+    }
+    free(filter->globs);
+    free(filter);
+}
+
+/* Swap in a new thread filter (NULL = all threads) and retire the old
+ * one; callbacks mid-check keep a valid snapshot. */
+static void publish_thread_filter(ThreadFilter *filter) {
+    ThreadFilter *old = atomic_exchange_explicit(&g_thread_filter, filter,
+                                                 memory_order_acq_rel);
+    if (old != NULL) {
+        old->retired = g_retired_filters;
+        g_retired_filters = old;
+    }
+}
+
+/* Free every retired filter. Only safe once the callbacks are
+ * uninstalled (teardown), when no reader can hold a snapshot. */
+static void free_retired_thread_filters(void) {
+    ThreadFilter *filter = g_retired_filters;
+    while (filter != NULL) {
+        ThreadFilter *next = filter->retired;
+        free_thread_filter(filter);
+        filter = next;
+    }
+    g_retired_filters = NULL;
+}
+
+/* Evaluate the thread filter for the calling thread: armed when any
+ * glob matches the threading.Thread name or its decimal ident. The
+ * verdict is cached thread-locally; a generation bump (reconfigure or
+ * clear_cache) forces re-evaluation, which also covers threads whose
+ * names change after their first call.
+ *
+ * The thread is looked up in threading._active rather than through
+ * current_thread(): the first events on a new thread fire inside
+ * Thread._bootstrap, before the thread registers itself, and
+ * current_thread() would both return a _DummyThread and permanently
+ * register it. An unregistered thread stays disarmed and uncached, so
+ * it is re-evaluated once registration has completed. */
+static bool matching_thread_check(void) {
+    /* Snapshot the filter once: a reconfigure can swap it mid-check */
+    ThreadFilter *filter = atomic_load_explicit(&g_thread_filter,
+                                                memory_order_acquire);
+    if (filter == NULL) {
+        t_thread_generation = atomic_load_explicit(&g_match_generation,
+                                                   memory_order_relaxed);
+        t_thread_armed = true;
+        return true;
+    }
+
+    /* Cache the verdict before calling into Python so any events fired
+     * while resolving the thread name see a settled (disarmed) state */
+    t_thread_generation = atomic_load_explicit(&g_match_generation,
+                                               memory_order_relaxed);
+    t_thread_armed = false;
+
+    unsigned long ident = PyThread_get_thread_ident();
+    char ident_buf[32];
+    snprintf(ident_buf, sizeof(ident_buf), "%lu", ident);
+
+    const char *name_utf8 = NULL;
+    PyObject *threading = PyImport_ImportModule("threading");
+    PyObject *active = NULL;
+    PyObject *name = NULL;
+    if (threading != NULL) {
+        active = PyObject_GetAttrString(threading, "_active");
+    }
+    if (active != NULL && PyDict_Check(active)) {
+        PyObject *ident_obj = PyLong_FromUnsignedLong(ident);
+        if (ident_obj != NULL) {
+            PyObject *thread = PyDict_GetItem(active, ident_obj);  /* borrowed */
+            Py_DECREF(ident_obj);
+            if (thread == NULL) {
+                /* Mid-bootstrap: stay disarmed for this call but leave
+                 * the verdict uncached so the next call re-evaluates */
+                t_thread_generation = 0;
+                Py_DECREF(active);
+                Py_XDECREF(threading);
+                PyErr_Clear();
+                return false;
+            }
+            name = PyObject_GetAttrString(thread, "name");
+        }
+    }
+    if (name != NULL && PyUnicode_Check(name)) {
+        name_utf8 = PyUnicode_AsUTF8(name);
+    }
+    if (name_utf8 == NULL) {
+        PyErr_Clear();
+    }
+
+    for (Py_ssize_t i = 0; i < filter->count; i++) {
+        if (fnmatch(filter->globs[i], ident_buf, 0) == 0 ||
+            (name_utf8 != NULL && fnmatch(filter->globs[i], name_utf8, 0) == 0)) {
+            t_thread_armed = true;
+            break;
+        }
+    }
+
+    Py_XDECREF(name);
+    Py_XDECREF(active);
+    Py_XDECREF(threading);
+    return t_thread_armed;
+}
+
+/* Fast path for the callbacks: one global load plus one TLS read when
+ * the cached verdict is current. Called before any other per-call work. */
+static inline bool matching_thread_armed(void) {
+    if (atomic_load_explicit(&g_thread_filter, memory_order_relaxed) == NULL) {
+        return true;
+    }
+    if (t_thread_generation == atomic_load_explicit(&g_match_generation,
+                                                    memory_order_relaxed)) {
+        return t_thread_armed;
+    }
+    return matching_thread_check();
+}
+
+/* ============================================================================
+ * Classification
+ * ============================================================================ */
+
+/* Fetch the cached classification record for a code object. Returns
+ * NULL when the code object is unclassified or its record is from an
+ * older generation. */
+static CodeExtraRecord* matching_get_record(PyCodeObject *code) {
+    void *extra = NULL;
+
+    if (g_extra_index < 0) {
+        return NULL;
+    }
+    if (SB_Code_GetExtra((PyObject *)code, g_extra_index, &extra) < 0) {
+        PyErr_Clear();
+        return NULL;
+    }
+
+    CodeExtraRecord *record = (CodeExtraRecord *)extra;
+    if (record != NULL &&
+        record->generation != atomic_load_explicit(&g_match_generation,
+                                                   memory_order_relaxed)) {
+        return NULL;  /* Stale; caller reclassifies */
+    }
+    return record;
+}
+
+/* Fetch the cached record regardless of generation. A stale record's
+ * verdict must not be trusted, but state that survives retargeting -
+ * the memoized qualified name - can be salvaged from it, making
+ * reclassification after a generation bump allocation-free. */
+static inline CodeExtraRecord* matching_get_any_record(PyCodeObject *code) {
+    void *extra = NULL;
+
+    if (g_extra_index < 0) {
+        return NULL;
+    }
+    if (SB_Code_GetExtra((PyObject *)code, g_extra_index, &extra) < 0) {
+        PyErr_Clear();
+        return NULL;
+    }
+    return (CodeExtraRecord *)extra;
+}
+
+/* Classify a code object against the pattern table and cache the result
+ * via co_extra. local_buf is used when caching fails, so a usable record
+ * is always returned. */
+static CodeExtraRecord* matching_classify(PyCodeObject *code,
+                                          const char *module_utf8,
+                                          const char *qualified_name_utf8,
+                                          CodeExtraRecord *local_buf) {
+    PatternTable *table = atomic_load_explicit(&g_pattern_table,
+                                               memory_order_acquire);
+    Py_ssize_t match_index = find_pattern_match(table, module_utf8,
+                                                qualified_name_utf8);
+
+    /* Resolve per-pattern overrides against the global defaults */
+    local_buf->generation = atomic_load_explicit(&g_match_generation,
+                                                 memory_order_relaxed);
+    local_buf->match = (match_index >= 0);
+    local_buf->caller_dependent = false;
+    local_buf->heap = false;
+    local_buf->has_delay_override = false;
+    local_buf->delay_ns = atomic_load_explicit(&g_delay_ns, memory_order_relaxed);
+    local_buf->frequency = atomic_load_explicit(&g_frequency, memory_order_relaxed);
+    atomic_store_explicit(&local_buf->call_count, 0, memory_order_relaxed);
+    local_buf->line_start = -1;
+    local_buf->line_end = -1;
+    local_buf->line_armed = false;
+    local_buf->rate_interval_ns = atomic_load_explicit(&g_rate_interval_ns,
+                                                       memory_order_relaxed);
+    atomic_store_explicit(&local_buf->rate_tat_ns, 0, memory_order_relaxed);
+    local_buf->qualname = NULL;
+    atomic_store_explicit(&local_buf->edges, NULL, memory_order_relaxed);
+    local_buf->retired_next = NULL;
+    if (match_index >= 0) {
+        CompiledPattern *pattern = &table->patterns[match_index];
+        if (pattern->rate_interval_ns > 0) {
+            local_buf->rate_interval_ns = pattern->rate_interval_ns;
+        }
+        if (pattern->caller_glob != NULL) {
+            /* Which edges actually bump is resolved per caller */
+            local_buf->caller_dependent = true;
+        }
+        if (pattern->delay_ns >= 0) {
+            local_buf->delay_ns = (uint64_t)pattern->delay_ns;
+            local_buf->has_delay_override = true;
+        }
+        if (pattern->frequency >= 1) {
+            local_buf->frequency = pattern->frequency;
+        }
+        local_buf->line_start = pattern->line_start;
+        local_buf->line_end = pattern->line_end;
+    }
+
+    /* Cache the record; fall back to the stack copy if caching fails */
+    if (g_extra_index >= 0) {
+        CodeExtraRecord *heap_record = malloc(sizeof(CodeExtraRecord));
+        if (heap_record != NULL) {
+            *heap_record = *local_buf;
+            heap_record->heap = true;
+            if (SB_Code_SetExtra((PyObject *)code, g_extra_index, heap_record) < 0) {
+                PyErr_Clear();
+                free(heap_record);
+            } else {
+                return heap_record;
+            }
+        }
+    }
+    return local_buf;
+}
+
+/* Look up the cached per-edge verdict for a caller-dependent record.
+ * Returns NULL when the edge has not been classified yet; the caller
+ * then derives the name strings and calls matching_classify_edge, so
+ * the cached path never touches them. */
+static inline CodeExtraRecord* matching_find_edge(CodeExtraRecord *record,
+                                                  void *caller_code) {
+    /* Acquire pairs with the release publish in matching_classify_edge,
+     * so a found edge is fully initialised; nodes are never unlinked
+     * while callbacks are installed, so the ->next walk is safe. */
+    EdgeRecord *edge = atomic_load_explicit(&record->edges, memory_order_acquire);
+    for (; edge != NULL; edge = edge->next) {
+        if (edge->caller_code == caller_code) {
+            return &edge->rec;
+        }
+    }
+    return NULL;
+}
+
+/* Classify one call edge of a caller-dependent code object against the
+ * full pattern table and cache the verdict on the record. As with
+ * matching_classify, local_buf is used when caching is not possible
+ * (the record itself is a stack fallback, or malloc fails), so a
+ * usable record is always returned. */
+static CodeExtraRecord* matching_classify_edge(CodeExtraRecord *record,
+                                               const char *module_utf8,
+                                               const char *qualified_name_utf8,
+                                               void *caller_code,
+                                               const char *caller_qualname,
+                                               CodeExtraRecord *local_buf) {
+    PatternTable *table = atomic_load_explicit(&g_pattern_table,
+                                               memory_order_acquire);
+    Py_ssize_t match_index = find_edge_pattern_match(table, module_utf8,
+                                                     qualified_name_utf8,
+                                                     caller_qualname);
+
+    local_buf->generation = record->generation;
+    local_buf->match = (match_index >= 0);
+    local_buf->caller_dependent = false;
+    local_buf->heap = false;
+    local_buf->has_delay_override = false;
+    local_buf->delay_ns = atomic_load_explicit(&g_delay_ns, memory_order_relaxed);
+    local_buf->frequency = atomic_load_explicit(&g_frequency, memory_order_relaxed);
+    atomic_store_explicit(&local_buf->call_count, 0, memory_order_relaxed);
+    /* Caller-qualified patterns cannot be line-scoped */
+    local_buf->line_start = -1;
+    local_buf->line_end = -1;
+    local_buf->line_armed = false;
+    local_buf->rate_interval_ns = atomic_load_explicit(&g_rate_interval_ns,
+                                                       memory_order_relaxed);
+    atomic_store_explicit(&local_buf->rate_tat_ns, 0, memory_order_relaxed);
+    local_buf->qualname = NULL;
+    atomic_store_explicit(&local_buf->edges, NULL, memory_order_relaxed);
+    local_buf->retired_next = NULL;
+    if (match_index >= 0) {
+        CompiledPattern *pattern = &table->patterns[match_index];
+        if (pattern->rate_interval_ns > 0) {
+            local_buf->rate_interval_ns = pattern->rate_interval_ns;
+        }
+        if (pattern->delay_ns >= 0) {
+            local_buf->delay_ns = (uint64_t)pattern->delay_ns;
+            local_buf->has_delay_override = true;
+        }
+        if (pattern->frequency >= 1) {
+            local_buf->frequency = pattern->frequency;
+        }
+    }
+
+    if (record->heap) {
+        EdgeRecord *edge = malloc(sizeof(EdgeRecord));
+        if (edge != NULL) {
+            edge->caller_code = caller_code;
+            edge->rec = *local_buf;
+            /* CAS-push with release so a concurrent matching_find_edge
+             * never sees a half-initialised node and racing classifiers
+             * cannot lose each other's inserts. Two threads classifying
+             * the same edge at once may both push; the walk returns the
+             * first hit, so the duplicate is harmless. */
+            EdgeRecord *head = atomic_load_explicit(&record->edges,
+                                                    memory_order_relaxed);
+            do {
+                edge->next = head;
+            } while (!atomic_compare_exchange_weak_explicit(&record->edges,
+                                                            &head, edge,
+                                                            memory_order_release,
+                                                            memory_order_relaxed));
+            return &edge->rec;
+        }
+    }
+    return local_buf;
+}
+
+/* ============================================================================
+ * Bump Dispatch
+ *
+ * The common tail of both backends' callbacks for a code object already
+ * classified as a match: timing window, sweep phase, frequency gating,
+ * the delay itself and the stats record.
+ * ============================================================================ */
+
+/* Token bucket (GCRA form) for the rate cap: one token per
+ * rate_interval_ns, with a burst allowance of one second's worth so a
+ * fresh record bumps immediately. The theoretical arrival time is
+ * advanced with a relaxed CAS loop - callbacks can race from no-GIL
+ * flusher-free contexts in future and the bucket must never over-grant. */
+static inline bool rate_gate_allow(CodeExtraRecord *record) {
+    int64_t interval = record->rate_interval_ns;
+    int64_t tau = 1000000000LL - interval;  /* burst: one second of tokens */
+    if (tau < 0) {
+        tau = 0;
+    }
+    int64_t now = (int64_t)monotonic_ns();
+    int64_t tat = atomic_load_explicit(&record->rate_tat_ns, memory_order_relaxed);
+    for (;;) {
+        if (now < tat - tau) {
+            return false;  /* Bucket empty */
+        }
+        int64_t next = (tat > now ? tat : now) + interval;
+        if (atomic_compare_exchange_weak_explicit(&record->rate_tat_ns, &tat, next,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+            return true;
+        }
+    }
+}
+
+static void matching_bump(PyCodeObject *code, CodeExtraRecord *record) {
+    /* Timing window: the scheduler keeps the armed flag in step with
+     * the window (and duty-cycle) boundaries, so the hot path reads
+     * one relaxed atomic instead of CLOCK_REALTIME */
+    if (!atomic_load_explicit(&g_window_armed, memory_order_relaxed)) {
+        return;  /* Before start, past end, or in an off phase */
+    }
+
+    /* Resolve the delay: per-pattern override, else the current sweep
+     * phase, else the global default snapshot in the record. Sweeps
+     * still consult the clock - phase selection needs it. */
+    uint64_t delay_ns = record->delay_ns;
+    if (!record->has_delay_override) {
+        SweepSchedule *sweep = atomic_load_explicit(&g_sweep_schedule,
+                                                    memory_order_acquire);
+        if (sweep != NULL && !sweep_current_delay(sweep, get_time_ns(), &delay_ns)) {
+            return;  /* Sweep exhausted */
+        }
+    }
+
+    /* A rate cap replaces frequency gating where one is set; otherwise
+     * handle frequency: only delay every Nth call. The counter lives in
+     * the cached record, so this is one increment and one modulo - no
+     * allocation on the hot path. Callbacks can race here without the
+     * GIL, so the counter is advanced with a relaxed fetch_add, like
+     * rate_tat_ns above. */
+    if (record->rate_interval_ns > 0) {
+        if (!rate_gate_allow(record)) {
+            return;  /* Over the bumps-per-second cap */
+        }
+    } else if (record->frequency > 1) {
+        uint64_t count = atomic_fetch_add_explicit(&record->call_count, 1,
+                                                   memory_order_relaxed) + 1;
+        if (count % (uint64_t)record->frequency != 0) {
+            return;  /* Not the Nth call */
+        }
+    }
+
+    /* Apply delay */
+    uint64_t applied_ns = apply_delay_ns(delay_ns);
+
+    if (g_bump_record != NULL) {
+        g_bump_record((uint64_t)(uintptr_t)code, applied_ns);
+    }
+}
+
+/* ============================================================================
+ * Stretch Dispatch
+ *
+ * In stretch mode matching calls record an entry timestamp on a
+ * per-thread side-stack instead of delaying on entry; the paired
+ * return event pops it and injects (stretch - 1) x the frame's own
+ * measured duration, so 'make this 50% slower' holds for cheap and
+ * expensive functions alike.
+ * ============================================================================ */
+
+/* Fixed-capacity per-thread side-stack: no allocation on the hot path
+ * and nothing to free on thread exit. Frames deeper than the capacity
+ * simply are not stretched. */
+#define SB_STRETCH_MAX_DEPTH 256
+
+typedef struct {
+    void *code;
+    uint64_t entry_ns;
+} StretchFrame;
+
+static __thread StretchFrame t_stretch_stack[SB_STRETCH_MAX_DEPTH];
+static __thread int t_stretch_depth = 0;
+
+static inline bool matching_stretch_active(void) {
+    return atomic_load_explicit(&g_stretch, memory_order_relaxed) > 1.0;
+}
+
+static inline void matching_stretch_enter(PyCodeObject *code) {
+    if (t_stretch_depth >= SB_STRETCH_MAX_DEPTH) {
+        return;
+    }
+    t_stretch_stack[t_stretch_depth].code = (void *)code;
+    t_stretch_stack[t_stretch_depth].entry_ns = monotonic_ns();
+    t_stretch_depth++;
+}
+
+/* Pop the entry for a returning code object and inject the
+ * proportional delay. The stack is scanned down from the top: entries
+ * above the match belong to frames that exited without a return event
+ * (exception unwinds, or returns while their record was stale) and are
+ * discarded, so one missed return cannot desynchronise the pairing.
+ * Recursive calls pair with the nearest (innermost) entry. */
+static void matching_stretch_return(PyCodeObject *code, CodeExtraRecord *record) {
+    uint64_t now_mono = monotonic_ns();
+
+    int found = -1;
+    for (int i = t_stretch_depth - 1; i >= 0; i--) {
+        if (t_stretch_stack[i].code == (void *)code) {
+            found = i;
+            break;
+        }
+    }
+    if (found < 0) {
+        return;  /* Entered before stretch was configured, or overflowed */
+    }
+
+    uint64_t duration_ns = now_mono - t_stretch_stack[found].entry_ns;
+    t_stretch_depth = found;
+
+    /* Timing window, via the scheduler's armed flag */
+    if (!atomic_load_explicit(&g_window_armed, memory_order_relaxed)) {
+        return;
+    }
+
+    /* Rate cap, else the frequency gate counted per completed call */
+    if (record->rate_interval_ns > 0) {
+        if (!rate_gate_allow(record)) {
+            return;
+        }
+    } else if (record->frequency > 1) {
+        uint64_t count = atomic_fetch_add_explicit(&record->call_count, 1,
+                                                   memory_order_relaxed) + 1;
+        if (count % (uint64_t)record->frequency != 0) {
+            return;
+        }
+    }
+
+    double stretch = atomic_load_explicit(&g_stretch, memory_order_relaxed);
+    if (stretch <= 1.0) {
+        return;  /* Reconfigured away mid-call */
+    }
+    uint64_t delay_ns = (uint64_t)((stretch - 1.0) * (double)duration_ns);
+    if (delay_ns == 0) {
+        return;
+    }
+
+    uint64_t applied_ns = apply_delay_ns(delay_ns);
+
+    if (g_bump_record != NULL) {
+        g_bump_record((uint64_t)(uintptr_t)code, applied_ns);
+    }
+}
+
+/* ============================================================================
+ * Configuration
+ * ============================================================================ */
+
+/* Parse a backend config dict (targets, delay_ns, delay_mode,
+ * delay_dist, frequency, rate, start_ns, end_ns, window, sweep,
+ * threads, stretch)
+ * into the native state and bump the cache generation. Returns 0 on
+ * success, -1 with an exception set on failure. */
+static int matching_configure(PyObject *config) {
+    PyObject *targets = PyDict_GetItemString(config, "targets");
+    PyObject *delay_obj = PyDict_GetItemString(config, "delay_ns");
+    PyObject *mode_obj = PyDict_GetItemString(config, "delay_mode");
+    PyObject *dist_obj = PyDict_GetItemString(config, "delay_dist");
+    PyObject *freq_obj = PyDict_GetItemString(config, "frequency");
+    PyObject *start_obj = PyDict_GetItemString(config, "start_ns");
+    PyObject *end_obj = PyDict_GetItemString(config, "end_ns");
+
+    if (targets == NULL || !PyList_Check(targets)) {
+        PyErr_SetString(PyExc_ValueError, "config['targets'] must be a list");
+        return -1;
+    }
+
+    if (delay_obj == NULL || !PyLong_Check(delay_obj)) {
+        PyErr_SetString(PyExc_ValueError, "config['delay_ns'] must be an integer");
+        return -1;
+    }
+
+    uint64_t delay_ns = PyLong_AsUnsignedLongLong(delay_obj);
+    if (PyErr_Occurred()) {
+        return -1;
+    }
+    atomic_store_explicit(&g_delay_ns, delay_ns, memory_order_relaxed);
+
+    if (mode_obj != NULL && PyUnicode_Check(mode_obj)) {
+        const char *mode = PyUnicode_AsUTF8(mode_obj);
+        if (mode == NULL) {
+            return -1;
+        }
+        if (timing_set_delay_mode(mode) < 0) {
+            PyErr_Format(PyExc_ValueError,
+                         "config['delay_mode']: unknown mode '%s'", mode);
+            return -1;
+        }
+    }
+
+    if (dist_obj != NULL && PyUnicode_Check(dist_obj)) {
+        const char *dist = PyUnicode_AsUTF8(dist_obj);
+        if (dist == NULL) {
+            return -1;
+        }
+        if (timing_set_delay_dist(dist) < 0) {
+            PyErr_Format(PyExc_ValueError,
+                         "config['delay_dist']: unknown distribution '%s'", dist);
+            return -1;
+        }
+    }
+
+    int frequency = 1;
+    if (freq_obj != NULL && PyLong_Check(freq_obj)) {
+        frequency = (int)PyLong_AsLong(freq_obj);
+        if (frequency < 1) frequency = 1;
+    }
+    atomic_store_explicit(&g_frequency, frequency, memory_order_relaxed);
+
+    /* The window bounds are stored relaxed: the scheduler thread reads
+     * them without the GIL and re-evaluates every tick */
+    int64_t start_ns = 0;
+    if (start_obj != NULL && PyLong_Check(start_obj)) {
+        start_ns = PyLong_AsLongLong(start_obj);
+    }
+    atomic_store_explicit(&g_start_ns, start_ns, memory_order_relaxed);
+
+    int64_t end_ns = 0;
+    if (end_obj != NULL && PyLong_Check(end_obj)) {
+        end_ns = PyLong_AsLongLong(end_obj);
+    }
+    atomic_store_explicit(&g_end_ns, end_ns, memory_order_relaxed);
+
+    double stretch = 0.0;
+    PyObject *stretch_obj = PyDict_GetItemString(config, "stretch");
+    if (stretch_obj != NULL && stretch_obj != Py_None) {
+        stretch = PyFloat_AsDouble(stretch_obj);
+        if (stretch == -1.0 && PyErr_Occurred()) {
+            return -1;
+        }
+    }
+    atomic_store_explicit(&g_stretch, stretch, memory_order_relaxed);
+
+    int64_t window_on_ns = 0;
+    int64_t window_off_ns = 0;
+    atomic_store_explicit(&g_window_on_ns, 0, memory_order_relaxed);
+    atomic_store_explicit(&g_window_off_ns, 0, memory_order_relaxed);
+    PyObject *window_obj = PyDict_GetItemString(config, "window");
+    if (window_obj != NULL && window_obj != Py_None) {
+        if (!PyTuple_Check(window_obj) || PyTuple_GET_SIZE(window_obj) != 2) {
+            PyErr_SetString(PyExc_ValueError,
+                            "config['window'] must be an (on_ns, off_ns) tuple");
+            return -1;
+        }
+        window_on_ns = PyLong_AsLongLong(PyTuple_GET_ITEM(window_obj, 0));
+        window_off_ns = PyLong_AsLongLong(PyTuple_GET_ITEM(window_obj, 1));
+        if (PyErr_Occurred()) {
+            return -1;
+        }
+        if (window_on_ns < 1 || window_off_ns < 1) {
+            PyErr_SetString(PyExc_ValueError,
+                            "config['window'] phases must be positive");
+            return -1;
+        }
+    }
+    atomic_store_explicit(&g_window_on_ns, window_on_ns, memory_order_relaxed);
+    atomic_store_explicit(&g_window_off_ns, window_off_ns, memory_order_relaxed);
+
+    int64_t rate_interval_ns = 0;
+    PyObject *rate_obj = PyDict_GetItemString(config, "rate");
+    if (rate_obj != NULL && rate_obj != Py_None) {
+        double rate = PyFloat_AsDouble(rate_obj);
+        if (rate == -1.0 && PyErr_Occurred()) {
+            return -1;
+        }
+        if (rate > 0.0) {
+            rate_interval_ns = (int64_t)(1e9 / rate);
+        }
+    }
+    atomic_store_explicit(&g_rate_interval_ns, rate_interval_ns,
+                          memory_order_relaxed);
+
+    /* Compile the sweep schedule into absolute phase end times. The
+     * schedule is built off to the side and only published once
+     * complete; the old one is retired, not freed, in case a callback
+     * is still reading it. */
+    PyObject *sweep_obj = PyDict_GetItemString(config, "sweep");
+    if (sweep_obj != NULL && PyList_Check(sweep_obj) && PyList_GET_SIZE(sweep_obj) > 0) {
+        Py_ssize_t len = PyList_GET_SIZE(sweep_obj);
+        SweepSchedule *sweep = calloc(1, sizeof(SweepSchedule));
+        if (sweep == NULL) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        sweep->delays = malloc((size_t)len * sizeof(uint64_t));
+        sweep->ends = malloc((size_t)len * sizeof(int64_t));
+        if (sweep->delays == NULL || sweep->ends == NULL) {
+            free_sweep_schedule(sweep);
+            PyErr_NoMemory();
+            return -1;
+        }
+
+        int64_t phase_start = atomic_load_explicit(&g_start_ns,
+                                                   memory_order_relaxed);
+        for (Py_ssize_t i = 0; i < len; i++) {
+            PyObject *phase = PyList_GET_ITEM(sweep_obj, i);
+            if (!PyTuple_Check(phase) || PyTuple_GET_SIZE(phase) != 2) {
+                free_sweep_schedule(sweep);
+                PyErr_SetString(PyExc_ValueError,
+                                "config['sweep'] phases must be (delay_ns, duration_ns) tuples");
+                return -1;
+            }
+            uint64_t phase_delay = PyLong_AsUnsignedLongLong(PyTuple_GET_ITEM(phase, 0));
+            int64_t duration = PyLong_AsLongLong(PyTuple_GET_ITEM(phase, 1));
+            if (PyErr_Occurred()) {
+                free_sweep_schedule(sweep);
+                return -1;
+            }
+            phase_start += duration;
+            sweep->delays[i] = phase_delay;
+            sweep->ends[i] = phase_start;
+        }
+        sweep->len = len;
+        atomic_store_explicit(&sweep->index, -1, memory_order_relaxed);
+        publish_sweep_schedule(sweep);
+    } else {
+        publish_sweep_schedule(NULL);
+    }
+
+    /* Copy the thread filter globs (empty/missing = all threads). Like
+     * the pattern table, the filter is built off to the side and
+     * published whole; the old one is retired, not freed, in case a
+     * callback is mid-check against it. */
+    PyObject *threads_obj = PyDict_GetItemString(config, "threads");
+    if (threads_obj != NULL && PyList_Check(threads_obj) && PyList_GET_SIZE(threads_obj) > 0) {
+        Py_ssize_t len = PyList_GET_SIZE(threads_obj);
+        ThreadFilter *filter = calloc(1, sizeof(ThreadFilter));
+        if (filter == NULL) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        filter->globs = calloc((size_t)len, sizeof(char *));
+        if (filter->globs == NULL) {
+            free(filter);
+            PyErr_NoMemory();
+            return -1;
+        }
+        for (Py_ssize_t i = 0; i < len; i++) {
+            PyObject *glob = PyList_GET_ITEM(threads_obj, i);
+            const char *utf8 = PyUnicode_Check(glob) ? PyUnicode_AsUTF8(glob) : NULL;
+            if (utf8 == NULL) {
+                filter->count = i;
+                free_thread_filter(filter);
+                PyErr_SetString(PyExc_ValueError,
+                                "config['threads'] must be a list of strings");
+                return -1;
+            }
+            filter->globs[i] = strdup(utf8);
+            if (filter->globs[i] == NULL) {
+                filter->count = i;
+                free_thread_filter(filter);
+                PyErr_NoMemory();
+                return -1;
+            }
+        }
+        filter->count = len;
+        publish_thread_filter(filter);
+    } else {
+        publish_thread_filter(NULL);
+    }
+
+    /* Store targets reference */
+    Py_XDECREF(g_target_patterns);
+    Py_INCREF(targets);
+    g_target_patterns = targets;
+
+    /* Compile patterns into the native table */
+    if (compile_target_patterns(targets) < 0) {
+        Py_CLEAR(g_target_patterns);
+        return -1;
+    }
+
+    /* Get extra index for caching; records are malloc'd (and own their
+     * edge lists), so retire them when their code objects are
+     * deallocated or a stale record is replaced */
+    if (g_extra_index < 0) {
+        g_extra_index = SB_RequestCodeExtraIndex(matching_retire_record);
+        if (g_extra_index < 0) {
+            PyErr_SetString(PyExc_RuntimeError, "Failed to get code extra index");
+            return -1;
+        }
+    }
+
+    /* Invalidate records cached by any previous configuration */
+    atomic_fetch_add_explicit(&g_match_generation, 1, memory_order_relaxed);
+
+    window_scheduler_update();
+    return 0;
+}
+
+/* Drop the native config. Cached co_extra records stay attached to
+ * their code objects but are invalidated via the generation bump in
+ * the next matching_configure call. */
+static void matching_teardown(void) {
+    Py_CLEAR(g_target_patterns);
+
+    /* Unpublish the pattern table, sweep schedule and thread filter,
+     * then free the retired chains: the callbacks are uninstalled by
+     * now, so no reader can still hold a snapshot. */
+    publish_pattern_table(NULL);
+    publish_sweep_schedule(NULL);
+    publish_thread_filter(NULL);
+    free_retired_pattern_tables();
+    free_retired_sweep_schedules();
+    free_retired_thread_filters();
+    free_retired_records();
+
+    /* Stop the window scheduler and pin the flag armed */
+    atomic_store_explicit(&g_start_ns, 0, memory_order_relaxed);
+    atomic_store_explicit(&g_end_ns, 0, memory_order_relaxed);
+    atomic_store_explicit(&g_window_on_ns, 0, memory_order_relaxed);
+    atomic_store_explicit(&g_window_off_ns, 0, memory_order_relaxed);
+    window_scheduler_update();
+}
+
+/* Invalidate all cached classification records. */
+static void matching_clear_cache(void) {
+    atomic_fetch_add_explicit(&g_match_generation, 1, memory_order_relaxed);
+}
+
+#endif /* SPEED_BUMP_MATCHING_H */
@@ -8,6 +8,7 @@ It automatically selects the appropriate backend based on Python version:
 
 from __future__ import annotations
 
+import os
 import sys
 import threading
 from typing import TYPE_CHECKING
@@ -29,37 +30,237 @@ _USE_PEP669 = sys.version_info >= (3, 12)
 _config: Config | None = None
 
 
+def _stats_metadata(config: Config) -> str:
+    """Render the resolved configuration as the stats file's metadata
+    block: "key value" lines (the proc meta file format), one "target"
+    line per pattern. Stored in the header so a stats file can be
+    interpreted offline without the run's environment."""
+    lines = [
+        f"pid {os.getpid()}",
+        f"delay_ns {config.delay_ns}",
+        f"frequency {config.frequency}",
+        f"rate {config.rate}",
+        f"delay_mode {config.delay_mode}",
+        f"delay_dist {config.delay_dist}",
+        f"stretch {config.stretch}",
+        f"start_ns {config.start_ns}",
+        f"end_ns {config.end_ns if config.end_ns is not None else 0}",
+    ]
+    if config.window is not None:
+        lines.append(f"window {config.window[0]}:{config.window[1]}")
+    for delay_ns, duration_ns in config.sweep:
+        lines.append(f"sweep_phase {delay_ns}:{duration_ns}")
+    for pattern in config.targets:
+        lines.append(f"target {pattern.original}")
+    return "".join(line + "\n" for line in lines)
+
+
 # ============================================================================
 # PEP 669 Backend (Python 3.12+)
 # ============================================================================
 
 if _USE_PEP669:
+    import asyncio
+    import fnmatch
     import time
 
-    from speed_bump._core import spin_delay_ns
-    from speed_bump._patterns import matches_any
+    from speed_bump._core import (
+        apply_delay_ns,
+        set_delay_dist,
+        set_delay_mode,
+        stats_record,
+    )
+    from speed_bump._patterns import compile_matcher
+    from speed_bump.stats import PHASE_MARKER_ID
+
+    # Native PY_START handler: the whole hot path (cache lookup, window
+    # check, frequency counter, delay) runs in C, matching the overhead
+    # of the 3.10 setprofile backend. The pure-Python _call_handler
+    # below is kept as a fallback for _core builds without it.
+    try:
+        from speed_bump._core import (
+            monitoring_callback as _native_callback,
+            monitoring_clear_cache as _native_clear_cache,
+            monitoring_install as _native_install,
+            monitoring_line_callback as _native_line_callback,
+            monitoring_reconfigure as _native_reconfigure,
+            monitoring_return_callback as _native_return_callback,
+            monitoring_uninstall as _native_uninstall,
+            monitoring_unwind_callback as _native_unwind_callback,
+        )
+
+        _HAVE_NATIVE_HANDLER = True
+    except ImportError:
+        _HAVE_NATIVE_HANDLER = False
 
     # Tool ID for speed_bump monitoring (use 3 as a mid-range ID)
     TOOL_ID = 3
 
-    # Cache for code object match results: code_id -> (matches, qualified_name)
-    # Using id() as key since code objects are long-lived
-    _match_cache: dict[int, bool] = {}
-    _cache_lock = threading.Lock()
+    # Cache for code object match results: code_id -> (delay_override,
+    # frequency) for matches (delay_override is None when the pattern has
+    # no delay_ns= override and the default/sweep delay applies), None
+    # for non-matches. Using id() as key since code objects are long-lived.
+    #
+    # The shared dicts are read and published without a lock: verdicts
+    # are deterministic, so threads racing to classify the same code
+    # object store the same result, and a single dict assignment is
+    # atomic on both GIL and free-threaded builds. Each thread keeps a
+    # private first-level cache so steady-state lookups never touch the
+    # shared dict at all; invalidation replaces the shared dicts
+    # wholesale and bumps a generation that retires every thread's
+    # private cache on its next lookup. Classification storms on
+    # free-threaded builds therefore never serialise on a cache lock.
+    _match_cache: dict[int, object] = {}
+    _cache_generation: int = 0
+    _thread_caches: threading.local = threading.local()
+
+    # Sentinel cached for code objects whose verdict depends on the
+    # calling function; per-edge results live in _edge_cache, keyed by
+    # (caller code id, callee code id), so the frame inspection and
+    # pattern walk happen once per edge rather than per call
+    _CALLER_DEPENDENT = object()
+    _edge_cache: dict[tuple[int, int], tuple[int | None, int, None, float] | None] = {}
+
+    # C-call mode match cache, keyed by id(callable): (delay_override,
+    # frequency, rate) for matching builtin/extension callables, None for
+    # everything else (including Python functions, which PY_START
+    # already covers). Mirrors _match_cache's two-level lock-free layout
+    _c_call_cache: dict[int, tuple[int | None, int, float] | None] = {}
+
+    def _thread_cache() -> threading.local:
+        """Get this thread's private cache level, dropping it when the
+        generation has moved on (reconfigure or clear_cache)."""
+        tc = _thread_caches
+        if getattr(tc, "generation", -1) != _cache_generation:
+            tc.generation = _cache_generation
+            tc.match = {}
+            tc.edge = {}
+            tc.c_call = {}
+        return tc
+
+    def _invalidate_caches() -> None:
+        """Drop all cached match and edge verdicts.
+
+        The shared dicts are replaced wholesale (rebinding a module
+        global is a single atomic store) rather than cleared in place,
+        so concurrent readers only ever see a complete old dict or an
+        empty new one."""
+        global _match_cache, _edge_cache, _c_call_cache, _rate_tats, _cache_generation
+        _match_cache = {}
+        _edge_cache = {}
+        _c_call_cache = {}
+        _rate_tats = {}
+        _cache_generation += 1
+
+    # Sweep schedule state: a list of (delay_ns, end_ns) phases with
+    # absolute end times, or None when no sweep is configured. The
+    # current phase index only ever advances; _sweep_lock serialises
+    # advancing so each phase boundary is recorded exactly once.
+    _sweep_phases: list[tuple[int, int]] | None = None
+    _sweep_index: int = -1
+    _sweep_lock = threading.Lock()
 
     # Thread-local storage for call counters
     # Key is code object id, value is call count
     _call_counters: threading.local = threading.local()
 
+    # Rate cap token buckets (GCRA theoretical arrival times in ns),
+    # keyed per code object (or per C callable). Shared across threads -
+    # the cap is process-wide, matching the native path - and touched
+    # only under the GIL; an occasional racy over-grant on free-threaded
+    # builds is acceptable for a profiling cap
+    _rate_tats: dict[object, int] = {}
+
+    # Stretch mode side-stack: per-thread list of (code_id, entry_ns)
+    # pushed on PY_START for matching calls and popped on PY_RETURN,
+    # where the proportional delay is injected
+    _stretch_state: threading.local = threading.local()
+
+    # Thread filter globs and the per-thread armed verdict cache.
+    # Rebinding the local() on install discards stale verdicts.
+    _thread_globs: tuple[str, ...] = ()
+    _thread_state: threading.local = threading.local()
+
     # PEP 669 enabled flag
     _pep669_enabled: bool = False
 
-    def _get_counter_dict() -> dict[int, int]:
+    # Whether the registered callbacks are the native C ones. False in
+    # coroutine mode even when the native handler is available, since
+    # per-task frequency counting happens in the Python handlers
+    _native_active: bool = False
+
+    # Measured per-bump callback overhead, cached for the process
+    # lifetime so repeated install/uninstall cycles measure only once
+    _callback_overhead_ns: int | None = None
+
+    def _get_counter_dict() -> dict[object, int]:
         """Get the thread-local counter dictionary."""
         if not hasattr(_call_counters, "counters"):
             _call_counters.counters = {}
         return _call_counters.counters
 
+    def _counter_key(code: CodeType) -> object:
+        """Frequency counter key for a code object.
+
+        In coroutine mode the key is qualified by the running asyncio
+        task, so a task resumed 10,000 times is counted coherently even
+        when the event loop interleaves it with other tasks running the
+        same coroutine function. Outside a task (or outside a loop) the
+        plain per-thread counter applies.
+        """
+        if _config is not None and _config.coroutines:
+            try:
+                task = asyncio.current_task()
+            except RuntimeError:
+                task = None
+            if task is not None:
+                return (id(task), id(code))
+        return id(code)
+
+    def _rate_allow(key: object, rate: float) -> bool:
+        """Token-bucket gate for the rate cap (GCRA form).
+
+        One token refills every 1/rate seconds off the monotonic clock,
+        with a burst allowance of one second's worth so a freshly
+        matched code object bumps immediately. Returns True when a
+        token is available (and consumes it).
+        """
+        interval = int(1e9 / rate)
+        tau = max(1_000_000_000 - interval, 0)
+        now = time.monotonic_ns()
+        tat = _rate_tats.get(key, 0)
+        if now < tat - tau:
+            return False  # Bucket empty
+        _rate_tats[key] = max(tat, now) + interval
+        return True
+
+    def _thread_armed() -> bool:
+        """Check the thread filter for the calling thread.
+
+        The verdict is cached in thread-local storage, so non-targeted
+        threads pay one attribute read per call after their first.
+        """
+        if not _thread_globs:
+            return True
+        try:
+            return _thread_state.armed
+        except AttributeError:
+            pass
+        # Look the thread up in _active rather than via current_thread():
+        # the first events on a new thread fire inside Thread._bootstrap,
+        # before registration, and current_thread() would register a
+        # _DummyThread. Stay disarmed and uncached until registered.
+        ident = threading.get_ident()
+        thread = threading._active.get(ident)
+        if thread is None:
+            return False
+        armed = any(
+            fnmatch.fnmatch(thread.name, glob) or fnmatch.fnmatch(str(ident), glob)
+            for glob in _thread_globs
+        )
+        _thread_state.armed = armed
+        return armed
+
     def _get_code_qualified_name(code: CodeType) -> str:
         """Extract the qualified name from a code object.
 
@@ -69,23 +270,33 @@ if _USE_PEP669:
         """
         return code.co_qualname
 
-    def _check_match(code: CodeType, config: Config) -> bool:
+    def _check_match(code: CodeType, config: Config) -> object:
         """Check if a code object matches any target pattern.
 
-        Results are cached per code object to avoid repeated matching.
+        Returns (delay_override, frequency, line_range, rate) for the
+        code object - the matching pattern's delay_ns= override or None
+        when the default (or current sweep phase) delay applies, the
+        resolved frequency, the pattern's (start, end) line scope or
+        None for whole-function matches, and the resolved rate cap in
+        bumps per second (0 = off) - or None for non-matches. Code objects matched only
+        by caller-qualified patterns return _CALLER_DEPENDENT; the
+        per-edge verdict comes from _check_edge. Results are cached per
+        code object to avoid repeated matching.
         """
         code_id = id(code)
 
-        # Fast path: check cache without lock
-        if code_id in _match_cache:
-            return _match_cache[code_id]
-
-        # Slow path: compute match and cache
-        with _cache_lock:
-            # Double-check after acquiring lock
-            if code_id in _match_cache:
-                return _match_cache[code_id]
+        # Fast path: this thread's private cache
+        cache = _thread_cache().match
+        try:
+            return cache[code_id]
+        except KeyError:
+            pass
 
+        # Second level: the shared dict, read without a lock
+        shared = _match_cache
+        try:
+            result = shared[code_id]
+        except KeyError:
             # Get module and qualified name
             module = code.co_filename
             # Try to extract module name from code object
@@ -93,12 +304,162 @@ if _USE_PEP669:
             # For matching, we use the filename (allows glob on paths)
             qualified_name = _get_code_qualified_name(code)
 
-            result = matches_any(config.targets, module, qualified_name)
-            _match_cache[code_id] = result
-            return result
+            pattern = compile_matcher(config.targets).find_match(module, qualified_name)
+            if pattern is None:
+                result = None
+            elif pattern.caller_pattern is not None:
+                # Which edges actually bump is resolved per caller
+                result = _CALLER_DEPENDENT
+            else:
+                result = (
+                    pattern.delay_ns,
+                    pattern.frequency if pattern.frequency is not None else config.frequency,
+                    (pattern.line_start, pattern.line_end)
+                    if pattern.line_start is not None
+                    else None,
+                    pattern.rate if pattern.rate is not None else config.rate,
+                )
+            # Racing threads store the same deterministic verdict, so
+            # last-write-wins publication is safe
+            shared[code_id] = result
+
+        cache[code_id] = result
+        return result
+
+    def _check_edge(
+        code: CodeType, config: Config
+    ) -> tuple[int | None, int, None, float] | None:
+        """Resolve the verdict for one call edge of a caller-dependent
+        code object.
+
+        The calling frame is inspected and the pattern table walked only
+        on the first call of each (caller, callee) pair; afterwards the
+        verdict comes straight from _edge_cache.
+        """
+        # Frame 0 is this helper, 1 is _call_handler, 2 is the function
+        # being entered (the callback pushes no frame of its own), so
+        # the caller is at depth 3. Guard against the entered function's
+        # frame not being current (e.g. callbacks fired from C).
+        frame = sys._getframe(2)
+        if frame is not None and frame.f_code is code:
+            frame = frame.f_back
+        caller_code = frame.f_code if frame is not None else None
+
+        key = (id(caller_code), id(code))
+        cache = _thread_cache().edge
+        try:
+            return cache[key]
+        except KeyError:
+            pass
+
+        shared = _edge_cache
+        try:
+            edge = shared[key]
+        except KeyError:
+            caller_qualname = caller_code.co_qualname if caller_code is not None else None
+            pattern = compile_matcher(config.targets).find_edge_match(
+                code.co_filename, _get_code_qualified_name(code), caller_qualname
+            )
+            if pattern is None:
+                edge = None
+            else:
+                # Caller-qualified patterns cannot be line-scoped, so an
+                # edge verdict never carries a line range
+                edge = (
+                    pattern.delay_ns,
+                    pattern.frequency if pattern.frequency is not None else config.frequency,
+                    None,
+                    pattern.rate if pattern.rate is not None else config.rate,
+                )
+            shared[key] = edge
+
+        cache[key] = edge
+        return edge
+
+    def _sweep_delay(now_ns: int) -> int | None:
+        """Return the current sweep phase's delay, advancing phases as
+        their end times pass. Returns None once the sweep is exhausted.
+
+        The fast path is a lock-free read of the current phase; the lock
+        is only taken at phase boundaries, where the transition is
+        recorded into the statistics stream as a phase marker.
+        """
+        global _sweep_index
+
+        phases = _sweep_phases
+        if phases is None:
+            return None
+
+        index = _sweep_index
+        if 0 <= index < len(phases):
+            delay_ns, end_ns = phases[index]
+            if now_ns < end_ns:
+                return delay_ns
+        elif index >= len(phases):
+            return None  # Sweep already exhausted
+
+        with _sweep_lock:
+            index = _sweep_index
+            while index < len(phases):
+                if index >= 0 and now_ns < phases[index][1]:
+                    return phases[index][0]
+                index += 1
+                _sweep_index = index
+                if index < len(phases):
+                    # Entering a new phase: record the boundary so the
+                    # stats output can be segmented per phase
+                    stats_record(PHASE_MARKER_ID, phases[index][0])
+            return None
+
+    def _apply_config_state(config: Config) -> None:
+        """Swap in the Python-side runtime state for a configuration:
+        the config itself, the compiled sweep schedule and the thread
+        filter (with its per-thread verdict cache discarded)."""
+        global _config, _sweep_phases, _sweep_index, _thread_globs, _thread_state
+
+        _config = config
+
+        # Compile the sweep schedule into absolute phase end times
+        if config.sweep:
+            phase_start = config.start_ns
+            phases = []
+            for delay_ns, duration_ns in config.sweep:
+                phase_start += duration_ns
+                phases.append((delay_ns, phase_start))
+            _sweep_phases = phases
+            _sweep_index = -1
+        else:
+            _sweep_phases = None
+
+        _thread_globs = config.threads
+        _thread_state = threading.local()
+
+    def _native_config_dict(config: Config) -> dict:
+        """Build the config dict the native backend expects."""
+        return {
+            'targets': list(config.targets),
+            'delay_ns': config.delay_ns,
+            'delay_mode': config.delay_mode,
+            'delay_dist': config.delay_dist,
+            'frequency': config.frequency,
+            'rate': config.rate,
+            'start_ns': config.start_ns,
+            'end_ns': config.end_ns if config.end_ns is not None else 0,
+            'window': config.window,
+            'sweep': list(config.sweep),
+            'threads': list(config.threads),
+            'stretch': config.stretch,
+            'tool_id': TOOL_ID,
+        }
+
+    def _stretch_frames() -> list[tuple[int, int]]:
+        """Get the thread-local stretch side-stack of (code_id, entry_ns)."""
+        if not hasattr(_stretch_state, "frames"):
+            _stretch_state.frames = []
+        return _stretch_state.frames
 
     def _call_handler(code: CodeType, instruction_offset: int) -> object:
-        """Callback for PY_START events (function call start).
+        """Callback for PY_START events (and PY_RESUME in coroutine mode).
 
         This is invoked by sys.monitoring when a function call begins.
         We check if the code object matches our patterns and apply delay
@@ -117,11 +478,44 @@ if _USE_PEP669:
         if _config is None or not _config.enabled:
             return sys.monitoring.DISABLE
 
-        # Check if code object matches patterns (cached)
-        if not _check_match(code, _config):
+        # Thread filter first: never DISABLE here - the same code
+        # object may be called from an armed thread later
+        if not _thread_armed():
+            return None
+
+        # Check if code object matches patterns (cached); the resolved
+        # per-pattern (delay_ns, frequency) comes back with the match
+        resolved = _check_match(code, _config)
+        if resolved is None:
             # Disable monitoring for this code object - it will never match
             return sys.monitoring.DISABLE
 
+        if resolved is _CALLER_DEPENDENT:
+            # Never DISABLE here: the same code object may be reached
+            # from a matching caller later
+            resolved = _check_edge(code, _config)
+            if resolved is None:
+                return None
+
+        delay_override, frequency, line_range, rate = resolved
+
+        # Line-scoped match: arm LINE events for this code object only
+        # and hand the delays over to _line_handler. PY_START can then
+        # DISABLE itself - the local LINE events outlive it - so the
+        # steady-state cost of line targeting sits entirely on the
+        # targeted code object's lines.
+        if line_range is not None:
+            sys.monitoring.set_local_events(
+                TOOL_ID, code, sys.monitoring.events.LINE
+            )
+            return sys.monitoring.DISABLE
+
+        # Stretch mode: record the entry timestamp and delay on return
+        # instead, in proportion to the frame's measured duration
+        if _config.stretch > 1.0:
+            _stretch_frames().append((id(code), time.perf_counter_ns()))
+            return None
+
         # Check timing window
         now_ns = time.time_ns()
         if not _config.is_in_window(now_ns):
@@ -129,21 +523,384 @@ if _USE_PEP669:
             # (we might enter the window later)
             return None
 
-        # Handle frequency: only delay every Nth call
-        if _config.frequency > 1:
+        # Resolve the delay: per-pattern override, else the current
+        # sweep phase, else the configured default
+        if delay_override is not None:
+            delay_ns = delay_override
+        elif _sweep_phases is not None:
+            sweep_delay = _sweep_delay(now_ns)
+            if sweep_delay is None:
+                return None  # Sweep exhausted
+            delay_ns = sweep_delay
+        else:
+            delay_ns = _config.delay_ns
+
+        # A rate cap replaces frequency gating where one is set;
+        # otherwise handle frequency: only delay every Nth call
+        if rate > 0:
+            if not _rate_allow(id(code), rate):
+                return None  # Over the bumps-per-second cap
+        elif frequency > 1:
             counters = _get_counter_dict()
-            code_id = id(code)
-            count = counters.get(code_id, 0) + 1
-            counters[code_id] = count
+            key = _counter_key(code)
+            count = counters.get(key, 0) + 1
+            counters[key] = count
 
-            if count % _config.frequency != 0:
+            if count % frequency != 0:
                 # Not the Nth call, skip delay
                 return None
 
-        # Apply delay
-        spin_delay_ns(_config.delay_ns)
+        # Apply delay; record what was actually applied, which can differ
+        # from delay_ns when a stochastic distribution is configured
+        applied_ns = apply_delay_ns(delay_ns)
+        stats_record(id(code), applied_ns)
+        return None
+
+    def _line_handler(code: CodeType, line_number: int) -> object:
+        """Callback for LINE events, armed per code object by
+        _call_handler for line-scoped matches.
+
+        Lines inside the pattern's range go through the usual window,
+        sweep and frequency gates and are delayed. Lines outside it
+        return DISABLE, which the interpreter records per line, so each
+        out-of-range line fires exactly once per configuration and the
+        steady-state cost falls only on the targeted section.
+
+        Args:
+            code: The code object whose line is executing.
+            line_number: The source line number about to execute.
+
+        Returns:
+            sys.monitoring.DISABLE for out-of-range (or stale) lines,
+            None otherwise.
+        """
+        config = _config
+        if config is None or not config.enabled:
+            return sys.monitoring.DISABLE
+
+        if not _thread_armed():
+            return None
+
+        resolved = _check_match(code, config)
+        if resolved is None or resolved is _CALLER_DEPENDENT or resolved[2] is None:
+            # Local LINE events left over from an earlier configuration
+            return sys.monitoring.DISABLE
+
+        delay_override, frequency, (line_lo, line_hi), rate = resolved
+        if line_number < line_lo or line_number > line_hi:
+            return sys.monitoring.DISABLE
+
+        now_ns = time.time_ns()
+        if not config.is_in_window(now_ns):
+            return None
+
+        if delay_override is not None:
+            delay_ns = delay_override
+        elif _sweep_phases is not None:
+            sweep_delay = _sweep_delay(now_ns)
+            if sweep_delay is None:
+                return None  # Sweep exhausted
+            delay_ns = sweep_delay
+        else:
+            delay_ns = config.delay_ns
+
+        # Rate and frequency gate line executions, not calls, for
+        # line scopes
+        if rate > 0:
+            if not _rate_allow(id(code), rate):
+                return None
+        elif frequency > 1:
+            counters = _get_counter_dict()
+            key = _counter_key(code)
+            count = counters.get(key, 0) + 1
+            counters[key] = count
+            if count % frequency != 0:
+                return None
+
+        applied_ns = apply_delay_ns(delay_ns)
+        stats_record(id(code), applied_ns)
         return None
 
+    def _check_c_match(
+        func: object, config: Config
+    ) -> tuple[int | None, int, float] | None:
+        """Check if a builtin/extension callable matches any target
+        pattern.
+
+        C callables have no code object, so matching goes by
+        __module__ and __qualname__ (falling back to __name__) instead
+        of source location. Python callables - anything carrying a
+        __code__ - resolve to None here, since PY_START already covers
+        them and a second bump would double-count. Caller-qualified and
+        line-scoped patterns never match C calls: there is no callee
+        frame to scope by.
+
+        Returns (delay_override, frequency, rate) for matches, None
+        otherwise. Results are cached per callable, mirroring
+        _match_cache's two-level layout.
+        """
+        func_id = id(func)
+
+        cache = _thread_cache().c_call
+        try:
+            return cache[func_id]
+        except KeyError:
+            pass
+
+        shared = _c_call_cache
+        try:
+            result = shared[func_id]
+        except KeyError:
+            if hasattr(func, "__code__"):
+                result = None  # Python callable: PY_START's territory
+            else:
+                module = getattr(func, "__module__", None) or ""
+                name = getattr(func, "__qualname__", None) or getattr(
+                    func, "__name__", ""
+                )
+                pattern = compile_matcher(config.targets).find_match(module, name)
+                if (
+                    pattern is None
+                    or pattern.caller_pattern is not None
+                    or pattern.line_start is not None
+                ):
+                    result = None
+                else:
+                    result = (
+                        pattern.delay_ns,
+                        pattern.frequency
+                        if pattern.frequency is not None
+                        else config.frequency,
+                        pattern.rate if pattern.rate is not None else config.rate,
+                    )
+            shared[func_id] = result
+
+        cache[func_id] = result
+        return result
+
+    def _c_call_handler(
+        code: CodeType, instruction_offset: int, callable: object, arg0: object
+    ) -> object:
+        """Callback for CALL events, registered only in C-call mode.
+
+        CALL fires at the call site, before the callee runs, for every
+        call - C or Python - so the verdict cache above is what keeps
+        the common case cheap. Never returns DISABLE: CALL events
+        disable per call site, and a site that passes a non-matching
+        callable today may pass a matching one later (bound methods,
+        dispatch tables), so muting the site would silently drop bumps.
+
+        Args:
+            code: The code object containing the call site.
+            instruction_offset: Byte offset of the call (unused).
+            callable: The object about to be called.
+            arg0: The first argument, or MISSING (unused).
+        """
+        config = _config
+        if config is None or not config.enabled:
+            return None
+
+        if not _thread_armed():
+            return None
+
+        resolved = _check_c_match(callable, config)
+        if resolved is None:
+            return None
+
+        delay_override, frequency, rate = resolved
+
+        now_ns = time.time_ns()
+        if not config.is_in_window(now_ns):
+            return None
+
+        if delay_override is not None:
+            delay_ns = delay_override
+        elif _sweep_phases is not None:
+            sweep_delay = _sweep_delay(now_ns)
+            if sweep_delay is None:
+                return None  # Sweep exhausted
+            delay_ns = sweep_delay
+        else:
+            delay_ns = config.delay_ns
+
+        if rate > 0:
+            if not _rate_allow(("c", id(callable)), rate):
+                return None
+        elif frequency > 1:
+            counters = _get_counter_dict()
+            key = ("c", id(callable))
+            count = counters.get(key, 0) + 1
+            counters[key] = count
+            if count % frequency != 0:
+                return None
+
+        # The delay lands before the C call rather than around it;
+        # for throughput sensitivity the placement is equivalent
+        applied_ns = apply_delay_ns(delay_ns)
+        stats_record(id(callable), applied_ns)
+        return None
+
+    def _return_handler(code: CodeType, instruction_offset: int, retval: object) -> object:
+        """Callback for PY_RETURN events, registered only in stretch mode.
+
+        Coroutine mode additionally registers this for PY_YIELD, so
+        each resume-to-yield slice of a coroutine is stretched in
+        proportion to its own duration rather than its wall-clock
+        lifetime across suspensions.
+
+        Pops the frame's entry timestamp from the per-thread side-stack
+        and delays in proportion to its measured duration. Entries above
+        the popped one belong to frames that exited without a return
+        event (exception unwinds) and are discarded, so one missed
+        return cannot desynchronise the pairing; recursive calls pair
+        with the nearest (innermost) entry.
+
+        Args:
+            code: The code object of the returning function.
+            instruction_offset: Byte offset of the instruction (unused).
+            retval: The value being returned (unused).
+
+        Returns:
+            sys.monitoring.DISABLE for non-matching code objects,
+            None otherwise.
+        """
+        config = _config
+        if config is None or not config.enabled:
+            return sys.monitoring.DISABLE
+
+        if not _thread_armed():
+            return None
+
+        resolved = _check_match(code, config)
+        if resolved is None:
+            return sys.monitoring.DISABLE
+
+        now_mono = time.perf_counter_ns()
+        frames = _stretch_frames()
+        code_id = id(code)
+        for i in range(len(frames) - 1, -1, -1):
+            if frames[i][0] == code_id:
+                duration_ns = now_mono - frames[i][1]
+                del frames[i:]
+                break
+        else:
+            # Nothing pushed for this frame: entered before stretch was
+            # configured, or via a non-matching caller edge
+            return None
+
+        if not config.is_in_window(time.time_ns()):
+            return None
+
+        # Rate cap, else the frequency gate counted per completed call
+        if resolved is not _CALLER_DEPENDENT:
+            frequency, rate = resolved[1], resolved[3]
+        else:
+            frequency, rate = config.frequency, config.rate
+        if rate > 0:
+            if not _rate_allow(id(code), rate):
+                return None
+        elif frequency > 1:
+            counters = _get_counter_dict()
+            key = _counter_key(code)
+            count = counters.get(key, 0) + 1
+            counters[key] = count
+            if count % frequency != 0:
+                return None
+
+        delay_ns = int((config.stretch - 1.0) * duration_ns)
+        if delay_ns <= 0:
+            return None
+
+        applied_ns = apply_delay_ns(delay_ns)
+        stats_record(code_id, applied_ns)
+        return None
+
+    def _unwind_handler(code: CodeType, instruction_offset: int, exception: object) -> None:
+        """Callback for PY_UNWIND events, registered only in stretch mode.
+
+        Frames that exit via an exception fire PY_UNWIND instead of
+        PY_RETURN, and their side-stack entries must still be popped
+        (and stretched) or the pairing would leak. PY_UNWIND cannot be
+        disabled per code object, so the DISABLE verdict from the
+        shared return logic is discarded.
+        """
+        _return_handler(code, instruction_offset, exception)
+        return None
+
+    def _measure_callback_overhead_ns(use_native: bool) -> int:
+        """Measure the fixed per-bump cost of the active callback path.
+
+        Briefly monitors a private probe function at zero delay and
+        compares its per-call cost against an unmonitored baseline.
+        apply_delay_ns subtracts the result from every requested delay,
+        so the observed stall matches the requested one instead of
+        carrying a systematic overshoot that dominates at small delays.
+        """
+        global _callback_overhead_ns, _config
+
+        if _callback_overhead_ns is not None:
+            return _callback_overhead_ns
+
+        from speed_bump._core import set_callback_overhead_ns
+        from speed_bump._patterns import parse_pattern
+
+        iters = 5000
+
+        def _overhead_probe() -> None:
+            return None
+
+        probe_config = Config(
+            enabled=True,
+            targets=(parse_pattern("*:*_overhead_probe", 1),),
+            delay_ns=0,
+            frequency=1,
+            start_ns=time.time_ns() - 1_000_000_000,
+            end_ns=None,
+        )
+
+        t0 = time.perf_counter_ns()
+        for _ in range(iters):
+            _overhead_probe()
+        baseline = time.perf_counter_ns() - t0
+
+        if use_native:
+            _native_install(_native_config_dict(probe_config))
+            callback = _native_callback
+        else:
+            _config = probe_config
+            callback = _call_handler
+
+        sys.monitoring.use_tool_id(TOOL_ID, "speed_bump")
+        sys.monitoring.register_callback(
+            TOOL_ID, sys.monitoring.events.PY_START, callback
+        )
+        sys.monitoring.set_events(TOOL_ID, sys.monitoring.events.PY_START)
+        sys.monitoring.restart_events()
+        try:
+            _overhead_probe()  # classify (first-call cost excluded)
+            t0 = time.perf_counter_ns()
+            for _ in range(iters):
+                _overhead_probe()
+            monitored = time.perf_counter_ns() - t0
+        finally:
+            sys.monitoring.set_events(TOOL_ID, 0)
+            sys.monitoring.register_callback(
+                TOOL_ID, sys.monitoring.events.PY_START, None
+            )
+            sys.monitoring.free_tool_id(TOOL_ID)
+            if use_native:
+                _native_uninstall()
+            else:
+                _config = None
+                _invalidate_caches()
+
+        # Clamp to 10us: a larger figure means the measurement was
+        # disturbed, and over-compensating would swallow small delays
+        overhead = max((monitored - baseline) // iters, 0)
+        _callback_overhead_ns = int(min(overhead, 10_000))
+        set_callback_overhead_ns(_callback_overhead_ns)
+        return _callback_overhead_ns
+
     def install(config: Config) -> bool:
         """Install speed_bump monitoring with the given configuration.
 
@@ -153,7 +910,7 @@ if _USE_PEP669:
         Returns:
             True if monitoring was installed, False if disabled or error.
         """
-        global _config, _pep669_enabled
+        global _pep669_enabled, _native_active
 
         if not config.enabled:
             return False
@@ -161,9 +918,42 @@ if _USE_PEP669:
         if not config.targets:
             return False
 
-        _config = config
+        # Prefer the native handler, except in coroutine mode: per-task
+        # frequency counting needs asyncio.current_task(), which the C
+        # handler cannot reach, so the Python handlers take over there
+        use_native = _HAVE_NATIVE_HANDLER and not config.coroutines
+
+        try:
+            # Measure the callback's own per-bump cost once, before the
+            # real tool ID registration, so delays can be compensated
+            _measure_callback_overhead_ns(use_native)
+        except Exception:
+            pass  # Compensation is best effort; uncompensated still works
+
+        _apply_config_state(config)
 
         try:
+            # Select the delay mode and distribution in the C extension
+            set_delay_mode(config.delay_mode)
+            set_delay_dist(config.delay_dist)
+
+            # Start statistics collection if configured
+            if config.stats_path is not None:
+                from speed_bump._core import stats_start
+
+                stats_start(config.stats_path, _stats_metadata(config))
+
+            if use_native:
+                _native_install(_native_config_dict(config))
+                callback = _native_callback
+                return_callback = _native_return_callback
+                unwind_callback = _native_unwind_callback
+            else:
+                callback = _call_handler
+                return_callback = _return_handler
+                unwind_callback = _unwind_handler
+            _native_active = use_native
+
             # Register our tool
             sys.monitoring.use_tool_id(TOOL_ID, "speed_bump")
 
@@ -171,36 +961,249 @@ if _USE_PEP669:
             sys.monitoring.register_callback(
                 TOOL_ID,
                 sys.monitoring.events.PY_START,
-                _call_handler,
+                callback,
             )
 
-            # Enable PY_START events globally
-            sys.monitoring.set_events(TOOL_ID, sys.monitoring.events.PY_START)
+            # Stretch mode pairs each PY_START with its PY_RETURN (or
+            # PY_UNWIND, for frames exiting via an exception) to measure
+            # the frame's duration; the exit events are only paid for
+            # when a stretch factor is configured
+            events = sys.monitoring.events.PY_START
+            if config.stretch > 1.0:
+                sys.monitoring.register_callback(
+                    TOOL_ID,
+                    sys.monitoring.events.PY_RETURN,
+                    return_callback,
+                )
+                sys.monitoring.register_callback(
+                    TOOL_ID,
+                    sys.monitoring.events.PY_UNWIND,
+                    unwind_callback,
+                )
+                events |= (
+                    sys.monitoring.events.PY_RETURN | sys.monitoring.events.PY_UNWIND
+                )
+
+            # Coroutine mode bumps matching coroutines and generators
+            # on every resume, not just the initial call. PY_RESUME has
+            # the same signature and DISABLE discipline as PY_START, so
+            # the one callback serves both; with stretch also active,
+            # PY_YIELD pairs each resume with the end of its slice.
+            if config.coroutines:
+                sys.monitoring.register_callback(
+                    TOOL_ID,
+                    sys.monitoring.events.PY_RESUME,
+                    callback,
+                )
+                events |= sys.monitoring.events.PY_RESUME
+                if config.stretch > 1.0:
+                    sys.monitoring.register_callback(
+                        TOOL_ID,
+                        sys.monitoring.events.PY_YIELD,
+                        return_callback,
+                    )
+                    events |= sys.monitoring.events.PY_YIELD
+
+            # Line-scoped patterns delay per executed line. The LINE
+            # callback is registered up front, but LINE events are only
+            # ever armed locally - per matching code object, from the
+            # PY_START callback - so the interpreter-wide LINE firehose
+            # stays off and untargeted code pays nothing.
+            if any(p.line_start is not None for p in config.targets):
+                sys.monitoring.register_callback(
+                    TOOL_ID,
+                    sys.monitoring.events.LINE,
+                    _native_line_callback if use_native else _line_handler,
+                )
+
+            # C-call mode intercepts builtin/extension calls via CALL
+            # events, which fire for every call and cannot be DISABLEd
+            # per callable - this is the interpreter-wide firehose, paid
+            # only when explicitly opted into. The handler is always the
+            # Python one: the native backend keys off code objects,
+            # which C callables do not have.
+            if config.c_calls:
+                sys.monitoring.register_callback(
+                    TOOL_ID,
+                    sys.monitoring.events.CALL,
+                    _c_call_handler,
+                )
+                events |= sys.monitoring.events.CALL
+
+            # Enable events globally. restart_events() re-arms code
+            # objects a previous install returned DISABLE for -
+            # DISABLE outlives free_tool_id
+            sys.monitoring.set_events(TOOL_ID, events)
+            sys.monitoring.restart_events()
 
             _pep669_enabled = True
+
+            if config.control_path is not None:
+                from speed_bump import _control
+
+                _control.start(config.control_path)
+
             return True
 
         except Exception as e:
             print(f"speed_bump: ERROR: Failed to install monitoring: {e}", file=sys.stderr)
             return False
 
+    def reconfigure(config: Config) -> None:
+        """Atomically swap the live configuration without reinstalling.
+
+        Takes a full Config, as install() does. Cached match results
+        are invalidated and PY_START events are re-armed for code
+        objects the old configuration disabled, so new patterns take
+        effect on the next call of each function.
+
+        Raises:
+            RuntimeError: If monitoring is not installed.
+            ValueError: If the config is disabled or has no targets.
+        """
+        global _native_active
+
+        if not _pep669_enabled:
+            raise RuntimeError("speed_bump monitoring is not installed")
+        if not config.enabled or not config.targets:
+            raise ValueError("reconfigure requires an enabled config with targets")
+
+        _apply_config_state(config)
+        set_delay_mode(config.delay_mode)
+        set_delay_dist(config.delay_dist)
+
+        _invalidate_caches()
+
+        # Coroutine mode runs the Python handlers (per-task frequency
+        # counting is out of the C handler's reach), so toggling it
+        # live swaps the whole callback set
+        use_native = _HAVE_NATIVE_HANDLER and not config.coroutines
+        if use_native:
+            if _native_active:
+                _native_reconfigure(_native_config_dict(config))
+            else:
+                _native_install(_native_config_dict(config))
+        elif _native_active:
+            _native_uninstall()
+        if use_native != _native_active:
+            sys.monitoring.register_callback(
+                TOOL_ID,
+                sys.monitoring.events.PY_START,
+                _native_callback if use_native else _call_handler,
+            )
+            _native_active = use_native
+
+        # Track the stretch factor across reconfigurations: register or
+        # drop the exit callbacks and adjust the event mask to match
+        events = sys.monitoring.events.PY_START
+        if config.stretch > 1.0:
+            sys.monitoring.register_callback(
+                TOOL_ID,
+                sys.monitoring.events.PY_RETURN,
+                _native_return_callback if use_native else _return_handler,
+            )
+            sys.monitoring.register_callback(
+                TOOL_ID,
+                sys.monitoring.events.PY_UNWIND,
+                _native_unwind_callback if use_native else _unwind_handler,
+            )
+            events |= (
+                sys.monitoring.events.PY_RETURN | sys.monitoring.events.PY_UNWIND
+            )
+        else:
+            sys.monitoring.register_callback(
+                TOOL_ID, sys.monitoring.events.PY_RETURN, None
+            )
+            sys.monitoring.register_callback(
+                TOOL_ID, sys.monitoring.events.PY_UNWIND, None
+            )
+
+        # Track coroutine mode the same way (its handlers are always
+        # the Python ones)
+        if config.coroutines:
+            sys.monitoring.register_callback(
+                TOOL_ID,
+                sys.monitoring.events.PY_RESUME,
+                _call_handler,
+            )
+            events |= sys.monitoring.events.PY_RESUME
+            if config.stretch > 1.0:
+                sys.monitoring.register_callback(
+                    TOOL_ID,
+                    sys.monitoring.events.PY_YIELD,
+                    _return_handler,
+                )
+                events |= sys.monitoring.events.PY_YIELD
+            else:
+                sys.monitoring.register_callback(
+                    TOOL_ID, sys.monitoring.events.PY_YIELD, None
+                )
+        else:
+            sys.monitoring.register_callback(
+                TOOL_ID, sys.monitoring.events.PY_RESUME, None
+            )
+            sys.monitoring.register_callback(
+                TOOL_ID, sys.monitoring.events.PY_YIELD, None
+            )
+
+        # Track line-scoped patterns the same way; stale local LINE
+        # events disable themselves line by line through the callback
+        if any(p.line_start is not None for p in config.targets):
+            sys.monitoring.register_callback(
+                TOOL_ID,
+                sys.monitoring.events.LINE,
+                _native_line_callback if use_native else _line_handler,
+            )
+        else:
+            sys.monitoring.register_callback(
+                TOOL_ID, sys.monitoring.events.LINE, None
+            )
+
+        # Track C-call mode the same way (its handler is always the
+        # Python one)
+        if config.c_calls:
+            sys.monitoring.register_callback(
+                TOOL_ID,
+                sys.monitoring.events.CALL,
+                _c_call_handler,
+            )
+            events |= sys.monitoring.events.CALL
+        else:
+            sys.monitoring.register_callback(
+                TOOL_ID, sys.monitoring.events.CALL, None
+            )
+        sys.monitoring.set_events(TOOL_ID, events)
+
+        # Re-arm code objects the old configuration returned DISABLE for
+        sys.monitoring.restart_events()
+
     def uninstall() -> None:
         """Uninstall speed_bump monitoring."""
-        global _config, _pep669_enabled
+        global _config, _native_active, _pep669_enabled, _sweep_phases
 
         if not _pep669_enabled:
             return
 
+        from speed_bump import _control
+
+        _control.stop()
+
         try:
             # Disable events
             sys.monitoring.set_events(TOOL_ID, 0)
 
-            # Unregister callback
-            sys.monitoring.register_callback(
-                TOOL_ID,
+            # Unregister callbacks (the exit and resume events are
+            # no-ops unless stretch or coroutine mode registered them)
+            for event in (
                 sys.monitoring.events.PY_START,
-                None,
-            )
+                sys.monitoring.events.PY_RETURN,
+                sys.monitoring.events.PY_UNWIND,
+                sys.monitoring.events.PY_RESUME,
+                sys.monitoring.events.PY_YIELD,
+                sys.monitoring.events.LINE,
+                sys.monitoring.events.CALL,
+            ):
+                sys.monitoring.register_callback(TOOL_ID, event, None)
 
             # Free tool ID
             sys.monitoring.free_tool_id(TOOL_ID)
@@ -208,8 +1211,18 @@ if _USE_PEP669:
         except Exception:
             pass  # Best effort cleanup
 
+        if _native_active:
+            _native_uninstall()
+
+        # Stop statistics collection (no-op when not running)
+        from speed_bump._core import stats_stop
+
+        stats_stop()
+
         _pep669_enabled = False
+        _native_active = False
         _config = None
+        _sweep_phases = None
 
     def is_installed() -> bool:
         """Check if speed_bump monitoring is installed."""
@@ -217,9 +1230,12 @@ if _USE_PEP669:
 
     def clear_cache() -> None:
         """Clear the match cache. Useful for testing."""
-        global _match_cache
-        with _cache_lock:
-            _match_cache.clear()
+        _invalidate_caches()
+        if _HAVE_NATIVE_HANDLER:
+            _native_clear_cache()
+        if _pep669_enabled:
+            # Re-arm code objects previously returned DISABLE for
+            sys.monitoring.restart_events()
 
 
 # ============================================================================
@@ -227,13 +1243,104 @@ if _USE_PEP669:
 # ============================================================================
 
 else:
+    import time
+
     # Import the C extension for setprofile-based monitoring
     from speed_bump._setprofile import (
+        clear_cache_setprofile,
         install_setprofile,
         is_installed_setprofile,
+        reconfigure_setprofile,
+        set_callback_overhead_ns,
         uninstall_setprofile,
     )
 
+    # Measured per-bump callback overhead, cached for the process
+    # lifetime so repeated install/uninstall cycles measure only once
+    _callback_overhead_ns: int | None = None
+
+    def _setprofile_config_dict(config: Config) -> dict:
+        """Build the config dict the C extension expects."""
+        return {
+            'targets': list(config.targets),
+            'delay_ns': config.delay_ns,
+            'delay_mode': config.delay_mode,
+            'delay_dist': config.delay_dist,
+            'sweep': list(config.sweep),
+            'threads': list(config.threads),
+            'frequency': config.frequency,
+            'rate': config.rate,
+            'start_ns': config.start_ns,
+            'end_ns': config.end_ns if config.end_ns is not None else 0,
+            'window': config.window,
+            'stretch': config.stretch,
+        }
+
+    def _measure_callback_overhead_ns() -> int:
+        """Measure the fixed per-bump cost of the profile callback.
+
+        Briefly installs the backend against a private probe function
+        at zero delay and compares its per-call cost against an
+        unprofiled baseline. apply_delay_ns subtracts the result from
+        every requested delay, so the observed stall matches the
+        requested one instead of carrying a systematic overshoot that
+        dominates at small delays.
+        """
+        global _callback_overhead_ns
+
+        if _callback_overhead_ns is not None:
+            return _callback_overhead_ns
+
+        from speed_bump._patterns import parse_pattern
+
+        iters = 5000
+
+        def _overhead_probe() -> None:
+            return None
+
+        probe_config = Config(
+            enabled=True,
+            targets=(parse_pattern("*:*_overhead_probe", 1),),
+            delay_ns=0,
+            frequency=1,
+            start_ns=time.time_ns() - 1_000_000_000,
+            end_ns=None,
+        )
+
+        t0 = time.perf_counter_ns()
+        for _ in range(iters):
+            _overhead_probe()
+        baseline = time.perf_counter_ns() - t0
+
+        install_setprofile(_setprofile_config_dict(probe_config))
+        try:
+            _overhead_probe()  # classify (first-call cost excluded)
+            t0 = time.perf_counter_ns()
+            for _ in range(iters):
+                _overhead_probe()
+            monitored = time.perf_counter_ns() - t0
+        finally:
+            uninstall_setprofile()
+
+        # Clamp to 10us: a larger figure means the measurement was
+        # disturbed, and over-compensating would swallow small delays
+        overhead = max((monitored - baseline) // iters, 0)
+        _callback_overhead_ns = int(min(overhead, 10_000))
+        set_callback_overhead_ns(_callback_overhead_ns)
+
+        # _core carries its own copy of the timing state; keep its
+        # reported figure in sync with the compensation applied here
+        try:
+            from speed_bump._core import (
+                set_callback_overhead_ns as _core_set_callback_overhead_ns,
+            )
+
+            _core_set_callback_overhead_ns(_callback_overhead_ns)
+        except ImportError:
+            pass
+
+        return _callback_overhead_ns
+
     def install(config: Config) -> bool:
         """Install speed_bump monitoring with the given configuration.
 
@@ -251,28 +1358,89 @@ else:
         if not config.targets:
             return False
 
-        _config = config
+        try:
+            # Measure the callback's own per-bump cost once, before the
+            # real install, so delays can be compensated
+            _measure_callback_overhead_ns()
+        except Exception:
+            pass  # Compensation is best effort; uncompensated still works
+
+        if any(p.line_start is not None for p in config.targets):
+            # Line scoping needs PEP 669 LINE events; the setprofile
+            # backend sees calls only, so these patterns match whole
+            # functions here
+            print(
+                "speed_bump: WARNING: line-scoped patterns need Python 3.12+; "
+                "matching the whole function",
+                file=sys.stderr,
+            )
 
-        # Convert Config to dict for C extension
-        config_dict = {
-            'targets': list(config.targets),
-            'delay_ns': config.delay_ns,
-            'frequency': config.frequency,
-            'start_ns': config.start_ns,
-            'end_ns': config.end_ns if config.end_ns is not None else 0,
-        }
+        if config.c_calls:
+            # CALL events are PEP 669; this backend only sees Python
+            # frames, so builtin/extension calls stay invisible here
+            print(
+                "speed_bump: WARNING: c_calls needs Python 3.12+; "
+                "C calls will not be intercepted",
+                file=sys.stderr,
+            )
+
+        _config = config
 
         try:
-            install_setprofile(config_dict)
+            # Start statistics collection if configured
+            if config.stats_path is not None:
+                from speed_bump._core import stats_start
+
+                stats_start(config.stats_path, _stats_metadata(config))
+
+            install_setprofile(_setprofile_config_dict(config))
+
+            if config.control_path is not None:
+                from speed_bump import _control
+
+                _control.start(config.control_path)
+
             return True
         except Exception as e:
             print(f"speed_bump: ERROR: Failed to install monitoring: {e}", file=sys.stderr)
             return False
 
+    def reconfigure(config: Config) -> None:
+        """Atomically swap the live configuration without reinstalling.
+
+        Takes a full Config, as install() does. Records cached in code
+        objects' co_extra are invalidated via the generation counter,
+        so new patterns take effect on the next call of each function.
+
+        Raises:
+            RuntimeError: If monitoring is not installed.
+            ValueError: If the config is disabled or has no targets.
+        """
+        global _config
+
+        if not is_installed_setprofile():
+            raise RuntimeError("speed_bump monitoring is not installed")
+        if not config.enabled or not config.targets:
+            raise ValueError("reconfigure requires an enabled config with targets")
+
+        _config = config
+        reconfigure_setprofile(_setprofile_config_dict(config))
+
     def uninstall() -> None:
         """Uninstall speed_bump monitoring."""
         global _config
+
+        from speed_bump import _control
+
+        _control.stop()
+
         uninstall_setprofile()
+
+        # Stop statistics collection (no-op when not running)
+        from speed_bump._core import stats_stop
+
+        stats_stop()
+
         _config = None
 
     def is_installed() -> bool:
@@ -282,10 +1450,11 @@ else:
     def clear_cache() -> None:
         """Clear the match cache.
 
-        For setprofile backend, the cache is stored in code objects'
-        co_extra and cannot easily be cleared. This is a no-op.
+        Records cached in code objects' co_extra are generation-tagged;
+        clearing bumps the generation so every code object is
+        reclassified on its next call.
         """
-        pass
+        clear_cache_setprofile()
 
 
 # ============================================================================
@@ -3,7 +3,24 @@
 Target files contain glob patterns for matching Python code objects.
 Format: one pattern per line, comments start with #.
 
-Pattern format: module_glob:qualified_name_glob
+Pattern format: module_glob:qualified_name_glob[:line[-line]][<-caller_glob] [delay_ns=N] [freq=N] [rate=N]
+
+The optional delay_ns, freq and rate fields override the configured
+defaults for code objects matched by that line, so one run can probe
+several targets with different parameters. rate caps bumps per second
+(token bucket) instead of gating every Nth call, which keeps the
+injected load constant when the call rate swings between phases; it
+replaces freq for patterns that carry it.
+
+The optional <-caller_glob suffix restricts the pattern to calls
+reached from a matching caller (glob against the calling function's
+qualified name), so a hot shared function can be slowed only on the
+call path under investigation.
+
+The optional :line or :start-end suffix scopes the pattern to source
+lines within the matched function (3.12+ only), so one section of a
+long function can be slowed without touching the rest. Line numbers
+are absolute within the source file, as reported by tracebacks.
 
 Examples:
     # Match all methods of LlamaAttention class
@@ -14,12 +31,25 @@ Examples:
 
     # Match everything in a module
     mypackage.slow_module:*
+
+    # Per-pattern delay and frequency overrides
+    transformers.*:*Attention* delay_ns=50000 freq=10
+
+    # At most 200 bumps/second regardless of call rate
+    vllm.*:Sampler.forward rate=200
+
+    # Only when reached from LlamaAttention.forward
+    torch.nn.functional:linear<-LlamaAttention.forward
+
+    # Only lines 212-240 of execute_model (the CPU prep section)
+    vllm.worker.model_runner:ModelRunner.execute_model:212-240
 """
 
 from __future__ import annotations
 
 import fnmatch
 import os
+import re
 from dataclasses import dataclass
 from pathlib import Path
 
@@ -32,6 +62,47 @@ class TargetPattern:
     name_pattern: str
     original: str
 
+    delay_ns: int | None = None
+    """Per-pattern delay override, or None to use the configured default."""
+
+    frequency: int | None = None
+    """Per-pattern frequency override, or None to use the configured default."""
+
+    caller_pattern: str | None = None
+    """Glob the calling function's qualified name must match, or None
+    to match regardless of caller."""
+
+    line_start: int | None = None
+    """First source line the pattern is scoped to, or None to bump the
+    whole function. Line-scoped patterns delay per executed line within
+    the range (3.12+ LINE events) instead of per call."""
+
+    line_end: int | None = None
+    """Last source line of the scope, inclusive. Always set when
+    line_start is (a single :N suffix sets both to N)."""
+
+    rate: float | None = None
+    """Per-pattern bumps-per-second cap (token bucket), or None to use
+    the configured default. A pattern with a rate is not frequency
+    gated: the bucket replaces the every-Nth counter."""
+
+    def matches_caller(self, caller_qualname: str | None) -> bool:
+        """Check this pattern's caller constraint against a call edge.
+
+        Args:
+            caller_qualname: The __qualname__ of the calling function,
+                or None when there is no Python caller (top level).
+
+        Returns:
+            True if the pattern has no caller constraint or the caller
+            matches it.
+        """
+        if self.caller_pattern is None:
+            return True
+        return caller_qualname is not None and fnmatch.fnmatch(
+            caller_qualname, self.caller_pattern
+        )
+
     def matches(self, module_name: str, qualified_name: str) -> bool:
         """Check if this pattern matches the given code object.
 
@@ -51,6 +122,133 @@ class PatternError(Exception):
     """Error in pattern syntax or file format."""
 
 
+def _glob_to_regex(pattern: str) -> str:
+    """Translate a single fnmatch-style glob into a regex fragment.
+
+    Unlike fnmatch.translate, wildcards are translated to ``[^\\n]`` classes
+    so that a glob matching one field of a combined "module\\nname" string
+    can never spill across the newline separator into the other field.
+    """
+    parts: list[str] = []
+    i = 0
+    n = len(pattern)
+    while i < n:
+        c = pattern[i]
+        i += 1
+        if c == "*":
+            parts.append(r"[^\n]*")
+        elif c == "?":
+            parts.append(r"[^\n]")
+        elif c == "[":
+            j = i
+            if j < n and pattern[j] == "!":
+                j += 1
+            if j < n and pattern[j] == "]":
+                j += 1
+            while j < n and pattern[j] != "]":
+                j += 1
+            if j >= n:
+                parts.append(r"\[")
+            else:
+                stuff = pattern[i:j].replace("\\", r"\\")
+                if stuff.startswith("!"):
+                    stuff = "^" + stuff[1:]
+                elif stuff.startswith("^"):
+                    stuff = "\\" + stuff
+                parts.append(f"[{stuff}]")
+                i = j + 1
+        else:
+            parts.append(re.escape(c))
+    return "".join(parts)
+
+
+class CompiledMatcher:
+    """All target patterns compiled into a single alternation regex.
+
+    matches_any() loops over the pattern list calling fnmatch twice per
+    pattern, which makes uncached classification O(patterns) per code
+    object. This matcher joins every pattern into one regex matched
+    against "module\\nname" so classification is a single match call
+    regardless of pattern count. Each pattern is its own named group, so
+    the matching pattern can be recovered from a match if needed.
+    """
+
+    __slots__ = ("patterns", "_regex")
+
+    def __init__(self, patterns: tuple[TargetPattern, ...]) -> None:
+        self.patterns = patterns
+        if patterns:
+            alternatives = (
+                f"(?P<p{i}>{_glob_to_regex(p.module_pattern)}\\n{_glob_to_regex(p.name_pattern)})"
+                for i, p in enumerate(patterns)
+            )
+            self._regex: re.Pattern[str] | None = re.compile("|".join(alternatives))
+        else:
+            self._regex = None
+
+    def matches(self, module_name: str, qualified_name: str) -> bool:
+        """Check if any pattern matches the given code object."""
+        return self.find_match(module_name, qualified_name) is not None
+
+    def find_match(self, module_name: str, qualified_name: str) -> TargetPattern | None:
+        """Find the first pattern matching the given code object.
+
+        Caller constraints are ignored here: a caller-qualified pattern
+        is a potential match for its code object, and the constraint is
+        resolved per call edge via find_edge_match.
+
+        Returns:
+            The matching TargetPattern (whose per-pattern overrides apply
+            to the matched code object), or None if nothing matches.
+        """
+        if self._regex is None:
+            return None
+        match = self._regex.fullmatch(f"{module_name}\n{qualified_name}")
+        if match is None:
+            return None
+        # Exactly one alternative group matches; its group number is the
+        # pattern index plus one (the alternatives contain no inner groups).
+        return self.patterns[match.lastindex - 1]
+
+    def find_edge_match(
+        self, module_name: str, qualified_name: str, caller_qualname: str | None
+    ) -> TargetPattern | None:
+        """Find the first pattern matching a specific call edge.
+
+        Like find_match, but caller-qualified patterns only match when
+        the calling function's qualified name satisfies their caller
+        glob. Used on the per-edge slow path; the result is cached by
+        the backends per (caller, callee) pair.
+        """
+        first = self.find_match(module_name, qualified_name)
+        if first is None:
+            return None
+        if first.matches_caller(caller_qualname):
+            return first
+        # The structurally-first pattern was caller-constrained and this
+        # edge fails it; a later pattern may still match the edge.
+        start = self.patterns.index(first) + 1
+        for pattern in self.patterns[start:]:
+            if pattern.matches(module_name, qualified_name) and pattern.matches_caller(
+                caller_qualname
+            ):
+                return pattern
+        return None
+
+
+# Matchers are cached per pattern tuple so repeated matches_any() calls
+# against the same loaded targets reuse one compiled regex.
+_matcher_cache: dict[tuple[TargetPattern, ...], CompiledMatcher] = {}
+
+
+def compile_matcher(patterns: tuple[TargetPattern, ...]) -> CompiledMatcher:
+    """Get (building if necessary) the compiled matcher for a pattern tuple."""
+    matcher = _matcher_cache.get(patterns)
+    if matcher is None:
+        matcher = _matcher_cache.setdefault(patterns, CompiledMatcher(patterns))
+    return matcher
+
+
 def parse_pattern(line: str, line_number: int) -> TargetPattern:
     """Parse a single pattern line.
 
@@ -64,25 +262,121 @@ def parse_pattern(line: str, line_number: int) -> TargetPattern:
     Raises:
         PatternError: If the pattern syntax is invalid.
     """
-    if ":" not in line:
+    # Split off optional key=value overrides after the pattern itself.
+    # Only trailing fields containing '=' are overrides, so patterns with
+    # whitespace around the ':' separator keep working.
+    fields = line.split()
+    override_start = len(fields)
+    for i, field in enumerate(fields):
+        if "=" in field:
+            override_start = i
+            break
+
+    pattern_field = " ".join(fields[:override_start])
+
+    # Split off an optional <-caller_glob suffix qualifying the edge
+    pattern_field, caller_sep, caller_field = pattern_field.partition("<-")
+    caller_pattern: str | None = None
+    if caller_sep:
+        caller_pattern = caller_field.strip()
+        if not caller_pattern:
+            raise PatternError(f"Line {line_number}: Empty caller pattern in '{line}'")
+
+    if ":" not in pattern_field:
         raise PatternError(
             f"Line {line_number}: Invalid pattern '{line}' - missing ':' separator. "
             f"Expected format: module_glob:name_glob"
         )
 
-    parts = line.split(":", 1)
+    parts = pattern_field.split(":", 1)
     module_pattern = parts[0].strip()
     name_pattern = parts[1].strip()
 
+    # Split off an optional :line or :start-end suffix scoping the
+    # pattern to source lines. Qualified names never contain ':', and
+    # only a purely numeric tail is treated as a range, so existing
+    # two-field patterns are unaffected.
+    line_start: int | None = None
+    line_end: int | None = None
+    name_head, line_sep, line_field = name_pattern.rpartition(":")
+    if line_sep and re.fullmatch(r"\d+(?:-\d+)?", line_field.strip()):
+        start_str, _, end_str = line_field.strip().partition("-")
+        line_start = int(start_str)
+        line_end = int(end_str) if end_str else line_start
+        if line_start < 1:
+            raise PatternError(f"Line {line_number}: Line numbers start at 1 in '{line}'")
+        if line_end < line_start:
+            raise PatternError(
+                f"Line {line_number}: Line range {line_start}-{line_end} is "
+                f"backwards in '{line}'"
+            )
+        if caller_pattern is not None:
+            raise PatternError(
+                f"Line {line_number}: Line-scoped patterns cannot be "
+                f"caller-qualified in '{line}'"
+            )
+        name_pattern = name_head.strip()
+
     if not module_pattern:
         raise PatternError(f"Line {line_number}: Empty module pattern in '{line}'")
     if not name_pattern:
         raise PatternError(f"Line {line_number}: Empty name pattern in '{line}'")
 
+    delay_ns: int | None = None
+    frequency: int | None = None
+    rate: float | None = None
+
+    for field in fields[override_start:]:
+        key, sep, value = field.partition("=")
+        if not sep:
+            raise PatternError(
+                f"Line {line_number}: Invalid field '{field}' in '{line}'. "
+                f"Expected delay_ns=N, freq=N or rate=N"
+            )
+
+        if key == "rate":
+            # Bumps per second; fractional rates are meaningful
+            try:
+                rate = float(value)
+            except ValueError:
+                raise PatternError(
+                    f"Line {line_number}: Invalid number '{value}' for 'rate' in '{line}'"
+                ) from None
+            if rate <= 0:
+                raise PatternError(f"Line {line_number}: rate must be > 0 in '{line}'")
+            continue
+
+        try:
+            number = int(value)
+        except ValueError:
+            raise PatternError(
+                f"Line {line_number}: Invalid integer '{value}' for '{key}' in '{line}'"
+            ) from None
+
+        if key == "delay_ns":
+            if number < 0:
+                raise PatternError(f"Line {line_number}: delay_ns must be >= 0 in '{line}'")
+            delay_ns = number
+        elif key == "freq":
+            if number < 1:
+                raise PatternError(f"Line {line_number}: freq must be >= 1 in '{line}'")
+            frequency = number
+        else:
+            raise PatternError(
+                f"Line {line_number}: Unknown field '{key}' in '{line}'. "
+                f"Expected delay_ns, freq or rate"
+            )
+
     return TargetPattern(
         module_pattern=module_pattern,
         name_pattern=name_pattern,
         original=line,
+        delay_ns=delay_ns,
+        frequency=frequency,
+        caller_pattern=caller_pattern,
+        line_start=line_start,
+        line_end=line_end,
+        rate=rate,
     )
 
 
@@ -113,6 +407,10 @@ def load_targets(path: str | os.PathLike[str]) -> list[TargetPattern]:
 
             patterns.append(parse_pattern(line, line_number))
 
+    # Build the combined matcher once at load time so the first
+    # classification doesn't pay the regex compilation cost.
+    compile_matcher(tuple(patterns))
+
     return patterns
 
 
@@ -127,4 +425,4 @@ def matches_any(patterns: list[TargetPattern], module_name: str, qualified_name:
     Returns:
         True if any pattern matches.
     """
-    return any(p.matches(module_name, qualified_name) for p in patterns)
+    return compile_matcher(tuple(patterns)).matches(module_name, qualified_name)
@@ -12,77 +12,36 @@
 #define PY_SSIZE_T_CLEAN
 #include <Python.h>
 #include <frameobject.h>
+#include <fnmatch.h>
 #include <time.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
 
-/* Architecture-specific pause instruction */
-#ifdef __x86_64__
-#include <immintrin.h>
-#define CPU_PAUSE() _mm_pause()
-#elif defined(__aarch64__)
-#define CPU_PAUSE() __asm__ __volatile__("yield")
-#else
-#define CPU_PAUSE() ((void)0)
-#endif
+/* Shared timing backend. The state is per translation unit, so this
+ * module calibrates its own copy lazily at install time (silently;
+ * _core reports calibration results at import). */
+#include "_timing.h"
+
+/* Shared matching state: pattern table, co_extra classification
+ * records, window/sweep/frequency evaluation and config parsing. */
+#include "_matching.h"
 
 /* ============================================================================
  * Module State
  * ============================================================================ */
 
-/* Index for storing match cache in code object's co_extra */
-static Py_ssize_t g_extra_index = -1;
+/* Stats recording API imported from _core's capsule at install time.
+ * NULL when _core is unavailable; recording is skipped in that case. */
+typedef struct {
+    void (*record)(uint64_t code_id, uint64_t delay_ns);
+} SpeedBumpStatsAPI;
 
-/* Cached references to Python objects */
-static PyObject *g_patterns_module = NULL;
-static PyObject *g_matches_any_func = NULL;
-static PyObject *g_target_patterns = NULL;  /* List of TargetPattern objects */
+static SpeedBumpStatsAPI *g_stats_api = NULL;
 
-/* Configuration */
-static uint64_t g_delay_ns = 0;
-static int g_frequency = 1;
-static int64_t g_start_ns = 0;
-static int64_t g_end_ns = 0;  /* 0 = no end time */
 static bool g_installed = false;
 
-/* Thread-local call counters would require more complex handling.
- * For simplicity, we use a global dict (with GIL protection). */
-static PyObject *g_call_counters = NULL;
-
-/* Cache entry values stored in co_extra */
-#define CACHE_UNKNOWN  ((void*)0)
-#define CACHE_NO_MATCH ((void*)1)
-#define CACHE_MATCH    ((void*)2)
-
-/* ============================================================================
- * Time Utilities (duplicated from _core.c for independence)
- * ============================================================================ */
-
-static inline uint64_t timespec_to_ns(const struct timespec *ts) {
-    return (uint64_t)ts->tv_sec * 1000000000ULL + (uint64_t)ts->tv_nsec;
-}
-
-static inline int64_t get_time_ns(void) {
-    struct timespec ts;
-    clock_gettime(CLOCK_REALTIME, &ts);
-    return (int64_t)timespec_to_ns(&ts);
-}
-
-static void spin_delay_ns(uint64_t delay_ns) {
-    struct timespec start, now;
-
-    clock_gettime(CLOCK_MONOTONIC, &start);
-    uint64_t end_ns = timespec_to_ns(&start) + delay_ns;
-
-    for (;;) {
-        clock_gettime(CLOCK_MONOTONIC, &now);
-        if (timespec_to_ns(&now) >= end_ns) {
-            break;
-        }
-        CPU_PAUSE();
-    }
-}
-
 /* ============================================================================
  * Qualified Name Construction
  *
@@ -90,6 +49,11 @@ static void spin_delay_ns(uint64_t delay_ns) {
  * 1. Check if co_varnames[0] is "self" or "cls"
  * 2. If so, get the first local from the frame and extract its type name
  * 3. Return "ClassName.method_name" for methods, just "func_name" otherwise
+ *
+ * The constructed name is interned and memoized on the code object's
+ * classification record, so it is built at most once per code object:
+ * reclassification after retargeting (a generation bump) salvages the
+ * name from the stale record instead of re-deriving it.
  * ============================================================================ */
 
 static PyObject* get_qualified_name(PyFrameObject *frame, PyCodeObject *code) {
@@ -138,30 +102,24 @@ static PyObject* get_qualified_name(PyFrameObject *frame, PyCodeObject *code) {
     return co_name;
 }
 
-/* ============================================================================
- * Pattern Matching
- *
- * Calls into Python's _patterns.matches_any() for simplicity.
- * Returns: 1 = match, 0 = no match, -1 = error
- * ============================================================================ */
-
-static int check_pattern_match(PyObject *module_name, PyObject *qualified_name) {
-    if (g_matches_any_func == NULL || g_target_patterns == NULL) {
-        return 0;
+/* Qualified name for a code object: the memoized copy when any cached
+ * record (current or stale) carries one, otherwise freshly constructed
+ * and interned. Returns a new reference, or NULL with the error
+ * cleared. */
+static PyObject* memoized_qualified_name(PyFrameObject *frame, PyCodeObject *code) {
+    CodeExtraRecord *cached = matching_get_any_record(code);
+    if (cached != NULL && cached->qualname != NULL) {
+        Py_INCREF(cached->qualname);
+        return cached->qualname;
     }
 
-    PyObject *result = PyObject_CallFunctionObjArgs(
-        g_matches_any_func, g_target_patterns, module_name, qualified_name, NULL
-    );
-
-    if (result == NULL) {
-        PyErr_Clear();  /* Don't propagate errors from pattern matching */
-        return 0;
+    PyObject *qualified_name = get_qualified_name(frame, code);
+    if (qualified_name == NULL) {
+        PyErr_Clear();
+        return NULL;
     }
-
-    int matches = PyObject_IsTrue(result);
-    Py_DECREF(result);
-    return matches;
+    PyUnicode_InternInPlace(&qualified_name);
+    return qualified_name;
 }
 
 /* ============================================================================
@@ -172,102 +130,136 @@ static int profile_callback(PyObject *obj, PyFrameObject *frame, int what, PyObj
     (void)obj;
     (void)arg;
 
-    /* Only handle call events */
-    if (what != PyTrace_CALL) {
+    /* Stretch mode pairs returns with entries; setprofile delivers
+     * PyTrace_RETURN for exception exits too, so pairing stays exact */
+    if (what == PyTrace_RETURN) {
+        if (!matching_stretch_active() || !matching_thread_armed()) {
+            return 0;
+        }
+        PyCodeObject *ret_code = frame->f_code;
+        if (ret_code == NULL) {
+            return 0;
+        }
+        CodeExtraRecord *ret_record = matching_get_record(ret_code);
+        if (ret_record != NULL && ret_record->match) {
+            /* Caller-dependent code shares the side-stack: only edges
+             * that matched on entry pushed a frame, so a failed pop is
+             * the non-matching edge's return and nothing happens */
+            matching_stretch_return(ret_code, ret_record);
+        }
         return 0;
     }
 
-    PyCodeObject *code = frame->f_code;
-    if (code == NULL) {
+    /* Only handle call events otherwise */
+    if (what != PyTrace_CALL) {
         return 0;
     }
 
-    /* Check cache first */
-    void *cache_value = CACHE_UNKNOWN;
-    if (g_extra_index >= 0) {
-        if (_PyCode_GetExtra((PyObject *)code, g_extra_index, &cache_value) < 0) {
-            PyErr_Clear();
-            cache_value = CACHE_UNKNOWN;
-        }
+    /* Thread filter: non-targeted threads pay one TLS read and bail */
+    if (!matching_thread_armed()) {
+        return 0;
     }
 
-    if (cache_value == CACHE_NO_MATCH) {
-        return 0;  /* Known non-match */
+    PyCodeObject *code = frame->f_code;
+    if (code == NULL) {
+        return 0;
     }
 
-    bool is_match;
-
-    if (cache_value == CACHE_MATCH) {
-        is_match = true;
-    } else {
-        /* Compute match */
-        PyObject *module_name = code->co_filename;  /* Use filename for module matching */
-        PyObject *qualified_name = get_qualified_name(frame, code);
+    CodeExtraRecord local;
+    CodeExtraRecord *record = matching_get_record(code);
 
+    if (record == NULL) {
+        /* Look up (or construct) the qualified name and classify
+         * against the pattern table. The reference is held across
+         * classification: caching a fresh record frees any stale one,
+         * and with it the memo the name may have come from. */
+        PyObject *qualified_name = memoized_qualified_name(frame, code);
         if (qualified_name == NULL) {
-            PyErr_Clear();
             return 0;
         }
 
-        int match_result = check_pattern_match(module_name, qualified_name);
-        Py_DECREF(qualified_name);
-
-        is_match = (match_result > 0);
-
-        /* Cache the result */
-        if (g_extra_index >= 0) {
-            void *new_cache = is_match ? CACHE_MATCH : CACHE_NO_MATCH;
-            if (_PyCode_SetExtra((PyObject *)code, g_extra_index, new_cache) < 0) {
-                PyErr_Clear();
-            }
-        }
+        /* Use filename for module matching */
+        const char *module_utf8 = PyUnicode_AsUTF8(code->co_filename);
+        const char *name_utf8 = PyUnicode_AsUTF8(qualified_name);
 
-        if (!is_match) {
+        if (module_utf8 == NULL || name_utf8 == NULL) {
+            PyErr_Clear();
+            Py_DECREF(qualified_name);
             return 0;
         }
-    }
 
-    /* Check timing window */
-    int64_t now_ns = get_time_ns();
-
-    if (now_ns < g_start_ns) {
-        return 0;  /* Before start time */
+        record = matching_classify(code, module_utf8, name_utf8, &local);
+        if (record->heap) {
+            record->qualname = qualified_name;  /* record owns it now */
+        } else {
+            Py_DECREF(qualified_name);
+        }
     }
 
-    if (g_end_ns > 0 && now_ns >= g_end_ns) {
-        return 0;  /* After end time */
+    if (!record->match) {
+        return 0;  /* Known non-match */
     }
 
-    /* Handle frequency: only delay every Nth call */
-    if (g_frequency > 1 && g_call_counters != NULL) {
-        PyObject *code_id = PyLong_FromVoidPtr((void *)code);
-        if (code_id == NULL) {
-            PyErr_Clear();
-            return 0;
-        }
-
-        PyObject *count_obj = PyDict_GetItem(g_call_counters, code_id);
-        long count = 1;
-
-        if (count_obj != NULL && PyLong_Check(count_obj)) {
-            count = PyLong_AsLong(count_obj) + 1;
-        }
+    if (record->caller_dependent) {
+        /* Resolve the verdict for this call edge; the pattern walk and
+         * caller-name construction happen once per (caller, callee)
+         * pair, cached calls only walk the record's edge list. */
+        PyFrameObject *caller_frame = frame->f_back;  /* borrowed */
+        PyCodeObject *caller_code = caller_frame != NULL ? caller_frame->f_code : NULL;
+
+        CodeExtraRecord edge_local;
+        CodeExtraRecord *edge = matching_find_edge(record, (void *)caller_code);
+        if (edge == NULL) {
+            /* The callee's name sits in its own record's memo; the
+             * caller's memo (from the caller's record, any generation)
+             * is used when present */
+            PyObject *qualified_name = record->qualname != NULL
+                ? (Py_INCREF(record->qualname), record->qualname)
+                : memoized_qualified_name(frame, code);
+            PyObject *caller_qualname_obj = NULL;
+            const char *caller_qualname = NULL;
+            if (caller_code != NULL) {
+                caller_qualname_obj = memoized_qualified_name(caller_frame, caller_code);
+                if (caller_qualname_obj != NULL) {
+                    caller_qualname = PyUnicode_AsUTF8(caller_qualname_obj);
+                }
+            }
 
-        PyObject *new_count = PyLong_FromLong(count);
-        if (new_count != NULL) {
-            PyDict_SetItem(g_call_counters, code_id, new_count);
-            Py_DECREF(new_count);
+            const char *module_utf8 = NULL;
+            const char *name_utf8 = NULL;
+            if (qualified_name != NULL) {
+                module_utf8 = PyUnicode_AsUTF8(code->co_filename);
+                name_utf8 = PyUnicode_AsUTF8(qualified_name);
+            }
+            if (module_utf8 != NULL && name_utf8 != NULL) {
+                edge = matching_classify_edge(record, module_utf8, name_utf8,
+                                              (void *)caller_code, caller_qualname,
+                                              &edge_local);
+            } else {
+                PyErr_Clear();
+            }
+            Py_XDECREF(caller_qualname_obj);
+            Py_XDECREF(qualified_name);
+            if (PyErr_Occurred()) {
+                PyErr_Clear();
+            }
         }
-        Py_DECREF(code_id);
 
-        if (count % g_frequency != 0) {
-            return 0;  /* Not the Nth call */
+        if (edge != NULL && edge->match) {
+            if (matching_stretch_active()) {
+                matching_stretch_enter(code);
+            } else {
+                matching_bump(code, edge);
+            }
         }
+        return 0;
     }
 
-    /* Apply delay */
-    spin_delay_ns(g_delay_ns);
-
+    if (matching_stretch_active()) {
+        matching_stretch_enter(code);
+    } else {
+        matching_bump(code, record);
+    }
     return 0;
 }
 
@@ -284,9 +276,19 @@ PyDoc_STRVAR(install_doc,
 "    config: A dict with keys:\n"
 "        - targets: List of TargetPattern objects\n"
 "        - delay_ns: Delay in nanoseconds (int)\n"
+"        - delay_mode: 'spin' or 'hybrid' (str, default 'spin')\n"
+"        - delay_dist: 'fixed', 'normal', 'exponential' or 'pareto'\n"
+"          (str, default 'fixed')\n"
 "        - frequency: Trigger every Nth call (int, default 1)\n"
 "        - start_ns: Start time in nanoseconds (int, optional)\n"
 "        - end_ns: End time in nanoseconds (int, optional, 0 = no end)\n"
+"        - sweep: List of (delay_ns, duration_ns) phases stepped\n"
+"          through from start_ns (list, optional)\n"
+"        - threads: List of globs matched against thread names and\n"
+"          idents; only matching threads are bumped (list, optional)\n"
+"        - stretch: Multiplicative slowdown factor; > 1.0 replaces the\n"
+"          fixed entry delay with a return-time delay proportional to\n"
+"          each frame's measured duration (float, optional)\n"
 );
 
 static PyObject* py_install_setprofile(PyObject *self, PyObject *args) {
@@ -302,86 +304,60 @@ static PyObject* py_install_setprofile(PyObject *self, PyObject *args) {
         return NULL;
     }
 
-    /* Extract configuration */
-    PyObject *targets = PyDict_GetItemString(config, "targets");
-    PyObject *delay_obj = PyDict_GetItemString(config, "delay_ns");
-    PyObject *freq_obj = PyDict_GetItemString(config, "frequency");
-    PyObject *start_obj = PyDict_GetItemString(config, "start_ns");
-    PyObject *end_obj = PyDict_GetItemString(config, "end_ns");
+    /* Calibrate this module's timing backend (no-op after first install) */
+    timing_calibrate();
+    timing_calibrate_dispatch();
 
-    if (targets == NULL || !PyList_Check(targets)) {
-        PyErr_SetString(PyExc_ValueError, "config['targets'] must be a list");
+    /* Parse the config dict into the shared matching state */
+    if (matching_configure(config) < 0) {
         return NULL;
     }
 
-    if (delay_obj == NULL || !PyLong_Check(delay_obj)) {
-        PyErr_SetString(PyExc_ValueError, "config['delay_ns'] must be an integer");
-        return NULL;
+    /* Import the stats recording API from _core (optional) */
+    if (g_stats_api == NULL) {
+        g_stats_api = PyCapsule_Import("speed_bump._core._STATS_API", 0);
+        if (g_stats_api == NULL) {
+            PyErr_Clear();  /* stats unavailable; record nothing */
+        }
     }
-
-    g_delay_ns = PyLong_AsUnsignedLongLong(delay_obj);
-    if (PyErr_Occurred()) {
-        return NULL;
+    if (g_stats_api != NULL) {
+        g_bump_record = g_stats_api->record;
     }
 
-    g_frequency = 1;
-    if (freq_obj != NULL && PyLong_Check(freq_obj)) {
-        g_frequency = (int)PyLong_AsLong(freq_obj);
-        if (g_frequency < 1) g_frequency = 1;
-    }
-
-    g_start_ns = 0;
-    if (start_obj != NULL && PyLong_Check(start_obj)) {
-        g_start_ns = PyLong_AsLongLong(start_obj);
-    }
+    /* Install the profile function */
+    PyEval_SetProfile(profile_callback, NULL);
 
-    g_end_ns = 0;
-    if (end_obj != NULL && PyLong_Check(end_obj)) {
-        g_end_ns = PyLong_AsLongLong(end_obj);
-    }
+    g_installed = true;
+    Py_RETURN_NONE;
+}
 
-    /* Store targets reference */
-    Py_XDECREF(g_target_patterns);
-    Py_INCREF(targets);
-    g_target_patterns = targets;
+PyDoc_STRVAR(reconfigure_doc,
+"reconfigure_setprofile(config)\n"
+"\n"
+"Atomically swap the monitoring configuration in place.\n"
+"\n"
+"Takes the same config dict as install_setprofile. Records cached in\n"
+"code objects' co_extra are invalidated via the generation counter,\n"
+"so every code object is reclassified against the new pattern table\n"
+"on its next call - no restart required.\n"
+);
 
-    /* Import pattern matching function */
-    if (g_patterns_module == NULL) {
-        g_patterns_module = PyImport_ImportModule("speed_bump._patterns");
-        if (g_patterns_module == NULL) {
-            return NULL;
-        }
-    }
+static PyObject* py_reconfigure_setprofile(PyObject *self, PyObject *args) {
+    (void)self;
+    PyObject *config;
 
-    if (g_matches_any_func == NULL) {
-        g_matches_any_func = PyObject_GetAttrString(g_patterns_module, "matches_any");
-        if (g_matches_any_func == NULL) {
-            return NULL;
-        }
+    if (!PyArg_ParseTuple(args, "O!", &PyDict_Type, &config)) {
+        return NULL;
     }
 
-    /* Initialize call counters dict */
-    if (g_frequency > 1) {
-        Py_XDECREF(g_call_counters);
-        g_call_counters = PyDict_New();
-        if (g_call_counters == NULL) {
-            return NULL;
-        }
+    if (!g_installed) {
+        PyErr_SetString(PyExc_RuntimeError, "setprofile monitoring not installed");
+        return NULL;
     }
 
-    /* Get extra index for caching */
-    if (g_extra_index < 0) {
-        g_extra_index = _PyEval_RequestCodeExtraIndex(NULL);
-        if (g_extra_index < 0) {
-            PyErr_SetString(PyExc_RuntimeError, "Failed to get code extra index");
-            return NULL;
-        }
+    if (matching_configure(config) < 0) {
+        return NULL;
     }
-
-    /* Install the profile function */
-    PyEval_SetProfile(profile_callback, NULL);
-
-    g_installed = true;
     Py_RETURN_NONE;
 }
 
@@ -403,8 +379,7 @@ static PyObject* py_uninstall_setprofile(PyObject *self, PyObject *args) {
     PyEval_SetProfile(NULL, NULL);
 
     /* Clean up */
-    Py_CLEAR(g_target_patterns);
-    Py_CLEAR(g_call_counters);
+    matching_teardown();
 
     g_installed = false;
     Py_RETURN_NONE;
@@ -425,14 +400,79 @@ static PyObject* py_is_installed_setprofile(PyObject *self, PyObject *args) {
     return PyBool_FromLong(g_installed);
 }
 
+PyDoc_STRVAR(clear_cache_doc,
+"clear_cache_setprofile()\n"
+"\n"
+"Invalidate cached match results.\n"
+"\n"
+"Records cached in code objects' co_extra are generation-tagged;\n"
+"clearing bumps the generation so every code object is reclassified\n"
+"on its next call.\n"
+);
+
+static PyObject* py_clear_cache_setprofile(PyObject *self, PyObject *args) {
+    (void)self;
+    (void)args;
+    matching_clear_cache();
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(set_callback_overhead_doc,
+"set_callback_overhead_ns(nanoseconds)\n"
+"\n"
+"Record the measured per-bump cost of the profile callback.\n"
+"\n"
+"This module carries its own copy of the timing state, so the\n"
+"compensation must be set here as well as in _core. Subtracted from\n"
+"every requested delay so the observed stall matches the requested\n"
+"one.\n"
+);
+
+static PyObject* py_set_callback_overhead_ns(PyObject *self, PyObject *args) {
+    (void)self;
+    unsigned long long overhead;
+
+    if (!PyArg_ParseTuple(args, "K", &overhead)) {
+        return NULL;
+    }
+
+    timing_set_callback_overhead_ns((uint64_t)overhead);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(recalibrate_setprofile_doc,
+"recalibrate_setprofile()\n"
+"\n"
+"Re-measure this module's copy of the clock calibration and rewrite\n"
+"the per-host cache file. speed_bump.recalibrate() calls this after\n"
+"refreshing _core's copy; no-op before the first install (install\n"
+"calibrates lazily).\n"
+);
+
+static PyObject* py_recalibrate_setprofile(PyObject *self, PyObject *args) {
+    (void)self;
+    (void)args;
+
+    if (g_calibrated) {
+        timing_recalibrate();
+    }
+    Py_RETURN_NONE;
+}
+
 /* ============================================================================
  * Module Definition
  * ============================================================================ */
 
 static PyMethodDef module_methods[] = {
     {"install_setprofile", py_install_setprofile, METH_VARARGS, install_doc},
+    {"reconfigure_setprofile", py_reconfigure_setprofile, METH_VARARGS, reconfigure_doc},
     {"uninstall_setprofile", py_uninstall_setprofile, METH_NOARGS, uninstall_doc},
     {"is_installed_setprofile", py_is_installed_setprofile, METH_NOARGS, is_installed_doc},
+    {"clear_cache_setprofile", py_clear_cache_setprofile, METH_NOARGS, clear_cache_doc},
+    {"set_callback_overhead_ns", py_set_callback_overhead_ns, METH_VARARGS,
+     set_callback_overhead_doc},
+    {"recalibrate_setprofile", py_recalibrate_setprofile, METH_NOARGS,
+     recalibrate_setprofile_doc},
     {NULL, NULL, 0, NULL}
 };
 
@@ -0,0 +1,358 @@
+/*
+ * Speed Bump - Statistics collection
+ *
+ * Lock-free per-thread event recording, drained by a background flusher
+ * thread into a compact binary file.
+ *
+ * Included by _core.c only. The _setprofile backend reaches the
+ * recording function through the "speed_bump._core._STATS_API" capsule,
+ * so both backends write into the same rings and the same output file.
+ *
+ * Design:
+ * - Each recording thread owns a fixed-size ring of 24-byte records
+ *   (code-object id, monotonic timestamp, applied delay). Rings are
+ *   registered in a global list under a mutex; registration happens
+ *   once per thread, recording never takes a lock.
+ * - The writer publishes records with a release store of the head
+ *   index; the flusher consumes with an acquire load and advances the
+ *   tail. Single writer (the owning thread), single reader (the
+ *   flusher), so no CAS is needed anywhere on the hot path.
+ * - A full ring drops records (counted) rather than blocking: the
+ *   instrumented process must never stall on its own telemetry.
+ *
+ * When recording is disabled the hot-path cost is one relaxed atomic
+ * load.
+ *
+ * File format v2: 16-byte prelude (magic "SBST", u32 version, u64
+ * start timestamp), then three u64 calibration constants (clock read
+ * overhead, compensated per-bump overhead, minimum achievable delay)
+ * and a u32-length-prefixed UTF-8 metadata block ("key value" lines
+ * describing the resolved configuration, supplied by the caller),
+ * followed by raw StatsRecord structs in flush order. v1 files (no
+ * calibration block, no metadata) are still read by speed_bump.stats.
+ */
+
+#ifndef SPEED_BUMP_STATS_H
+#define SPEED_BUMP_STATS_H
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+#define STATS_MAGIC "SBST"
+#define STATS_VERSION 2
+#define STATS_RING_SLOTS 4096  /* power of two; 96KiB per thread */
+#define STATS_FLUSH_INTERVAL_US 10000
+
+/* code_id of sweep phase boundary markers (also defined by
+ * _matching.h, which is compiled without this header in the
+ * _setprofile extension) */
+#define PHASE_MARKER_ID 0
+
+/* code_id of throughput marker records written by speed_bump.mark():
+ * delay_ns carries the unit count instead of a delay (exported as
+ * speed_bump.stats.THROUGHPUT_MARKER_ID; small integers are never real
+ * code-object ids, which are heap addresses) */
+#define THROUGHPUT_MARKER_ID 1
+
+/* Phase markers bypass the per-thread rings (see stats_record): one
+ * slot per sweep phase is plenty, and a burst-filled ring must not be
+ * able to drop the boundary that segments it */
+#define STATS_MARKER_SLOTS 64
+
+typedef struct {
+    uint64_t code_id;   /* id() of the code object that was bumped */
+    uint64_t ts_ns;     /* CLOCK_MONOTONIC timestamp of the bump */
+    uint64_t delay_ns;  /* delay that was applied */
+} StatsRecord;
+
+typedef struct StatsRing {
+    _Alignas(64) _Atomic uint64_t head;  /* written by the owning thread */
+    _Alignas(64) _Atomic uint64_t tail;  /* written by the flusher */
+    _Atomic uint64_t dropped;
+    struct StatsRing *next;              /* global registry chain */
+    StatsRecord slots[STATS_RING_SLOTS];
+} StatsRing;
+
+static _Atomic bool g_stats_enabled = false;
+static _Atomic(StatsRing *) g_stats_rings = NULL;  /* registry head */
+static pthread_mutex_t g_stats_register_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t g_stats_flusher;
+static FILE *g_stats_file = NULL;
+static _Atomic bool g_stats_flusher_running = false;
+
+static _Thread_local StatsRing *t_stats_ring = NULL;
+
+/* Side buffer for phase boundary markers. Markers are written with the
+ * GIL held (single logical writer) and consumed by the flusher, so the
+ * head/tail discipline mirrors the rings. */
+static StatsRecord g_stats_markers[STATS_MARKER_SLOTS];
+static _Alignas(64) _Atomic uint64_t g_stats_marker_head = 0;
+static _Alignas(64) _Atomic uint64_t g_stats_marker_tail = 0;
+
+/* ============================================================================
+ * Recording (hot path)
+ * ============================================================================ */
+
+static StatsRing* stats_ring_create(void) {
+    StatsRing *ring = calloc(1, sizeof(StatsRing));
+    if (ring == NULL) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&g_stats_register_lock);
+    ring->next = atomic_load_explicit(&g_stats_rings, memory_order_relaxed);
+    atomic_store_explicit(&g_stats_rings, ring, memory_order_release);
+    pthread_mutex_unlock(&g_stats_register_lock);
+
+    t_stats_ring = ring;
+    return ring;
+}
+
+static void stats_record(uint64_t code_id, uint64_t delay_ns) {
+    if (!atomic_load_explicit(&g_stats_enabled, memory_order_relaxed)) {
+        return;
+    }
+
+    if (code_id == PHASE_MARKER_ID) {
+        /* Boundary markers segment the whole stream: losing one to a
+         * burst-filled ring would silently merge two phases, so they
+         * take the dedicated buffer. The reader splits on marker
+         * timestamps, not file order, so interleaving is preserved. */
+        uint64_t head = atomic_load_explicit(&g_stats_marker_head,
+                                             memory_order_relaxed);
+        uint64_t tail = atomic_load_explicit(&g_stats_marker_tail,
+                                             memory_order_acquire);
+        if (head - tail >= STATS_MARKER_SLOTS) {
+            return;  /* 64 undrained phases; not a realistic sweep */
+        }
+        StatsRecord *slot = &g_stats_markers[head & (STATS_MARKER_SLOTS - 1)];
+        slot->code_id = code_id;
+        slot->ts_ns = monotonic_ns();
+        slot->delay_ns = delay_ns;
+        atomic_store_explicit(&g_stats_marker_head, head + 1,
+                              memory_order_release);
+        return;
+    }
+
+    StatsRing *ring = t_stats_ring;
+    if (ring == NULL) {
+        ring = stats_ring_create();
+        if (ring == NULL) {
+            return;  /* allocation failed; drop silently */
+        }
+    }
+
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+    if (head - tail >= STATS_RING_SLOTS) {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    StatsRecord *slot = &ring->slots[head & (STATS_RING_SLOTS - 1)];
+    slot->code_id = code_id;
+    slot->ts_ns = monotonic_ns();
+    slot->delay_ns = delay_ns;
+
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+/* ============================================================================
+ * Flusher
+ * ============================================================================ */
+
+static void stats_drain_ring(StatsRing *ring) {
+    uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+    while (tail < head) {
+        StatsRecord *slot = &ring->slots[tail & (STATS_RING_SLOTS - 1)];
+        fwrite(slot, sizeof(StatsRecord), 1, g_stats_file);
+        tail++;
+    }
+
+    atomic_store_explicit(&ring->tail, tail, memory_order_release);
+}
+
+static void stats_drain_markers(void) {
+    uint64_t tail = atomic_load_explicit(&g_stats_marker_tail, memory_order_relaxed);
+    uint64_t head = atomic_load_explicit(&g_stats_marker_head, memory_order_acquire);
+
+    while (tail < head) {
+        StatsRecord *slot = &g_stats_markers[tail & (STATS_MARKER_SLOTS - 1)];
+        fwrite(slot, sizeof(StatsRecord), 1, g_stats_file);
+        tail++;
+    }
+
+    atomic_store_explicit(&g_stats_marker_tail, tail, memory_order_release);
+}
+
+static void stats_drain_all(void) {
+    stats_drain_markers();
+    StatsRing *ring = atomic_load_explicit(&g_stats_rings, memory_order_acquire);
+    while (ring != NULL) {
+        stats_drain_ring(ring);
+        ring = ring->next;
+    }
+}
+
+static void* stats_flusher_main(void *arg) {
+    (void)arg;
+
+    while (atomic_load_explicit(&g_stats_flusher_running, memory_order_acquire)) {
+        stats_drain_all();
+        fflush(g_stats_file);
+
+        struct timespec interval = {
+            .tv_sec = 0,
+            .tv_nsec = STATS_FLUSH_INTERVAL_US * 1000L,
+        };
+        nanosleep(&interval, NULL);
+    }
+
+    /* Final drain after recording has been disabled */
+    stats_drain_all();
+    return NULL;
+}
+
+/* ============================================================================
+ * Lifecycle
+ *
+ * stats_start/stats_stop are called with the GIL held, which serialises
+ * them against each other.
+ * ============================================================================ */
+
+static int stats_start(const char *path, const char *meta, size_t meta_len) {
+    if (atomic_load_explicit(&g_stats_enabled, memory_order_relaxed)) {
+        return -1;  /* already running */
+    }
+
+    g_stats_file = fopen(path, "wb");
+    if (g_stats_file == NULL) {
+        return -2;
+    }
+
+    /* Header: magic, version, recording start timestamp, calibration
+     * constants, then the caller's configuration metadata block. Baking
+     * the calibration into the file lets offline analysis interpret
+     * delays without access to the recording host. */
+    uint32_t version = STATS_VERSION;
+    uint64_t start_ts = monotonic_ns();
+    uint64_t clock_overhead = timing_read_overhead_ns();
+    uint64_t bump_overhead = timing_bump_overhead_ns();
+    uint64_t min_delay = timing_min_delay_ns();
+    uint32_t meta_size = (meta != NULL) ? (uint32_t)meta_len : 0;
+    fwrite(STATS_MAGIC, 1, 4, g_stats_file);
+    fwrite(&version, sizeof(version), 1, g_stats_file);
+    fwrite(&start_ts, sizeof(start_ts), 1, g_stats_file);
+    fwrite(&clock_overhead, sizeof(clock_overhead), 1, g_stats_file);
+    fwrite(&bump_overhead, sizeof(bump_overhead), 1, g_stats_file);
+    fwrite(&min_delay, sizeof(min_delay), 1, g_stats_file);
+    fwrite(&meta_size, sizeof(meta_size), 1, g_stats_file);
+    if (meta_size > 0) {
+        fwrite(meta, 1, meta_size, g_stats_file);
+    }
+
+    atomic_store_explicit(&g_stats_flusher_running, true, memory_order_release);
+    if (pthread_create(&g_stats_flusher, NULL, stats_flusher_main, NULL) != 0) {
+        atomic_store_explicit(&g_stats_flusher_running, false, memory_order_release);
+        fclose(g_stats_file);
+        g_stats_file = NULL;
+        return -3;
+    }
+
+    atomic_store_explicit(&g_stats_enabled, true, memory_order_release);
+    return 0;
+}
+
+static uint64_t stats_dropped_total(void) {
+    uint64_t total = 0;
+    StatsRing *ring = atomic_load_explicit(&g_stats_rings, memory_order_acquire);
+    while (ring != NULL) {
+        total += atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+        ring = ring->next;
+    }
+    return total;
+}
+
+static void stats_stop(void) {
+    if (!atomic_load_explicit(&g_stats_enabled, memory_order_relaxed)) {
+        return;
+    }
+
+    atomic_store_explicit(&g_stats_enabled, false, memory_order_release);
+    atomic_store_explicit(&g_stats_flusher_running, false, memory_order_release);
+    pthread_join(g_stats_flusher, NULL);
+
+    fflush(g_stats_file);
+    fclose(g_stats_file);
+    g_stats_file = NULL;
+
+    /* Rings stay registered (threads may record again after a restart);
+     * reset their drop counters for the next session */
+    StatsRing *ring = atomic_load_explicit(&g_stats_rings, memory_order_acquire);
+    while (ring != NULL) {
+        atomic_store_explicit(&ring->dropped, 0, memory_order_relaxed);
+        ring = ring->next;
+    }
+}
+
+static void stats_fork_reset(void) {
+    /* Called in the child after fork(). The flusher thread did not
+     * survive the fork, so the usual stats_stop() would deadlock in
+     * pthread_join; instead, tear the inherited session down without
+     * touching the parent's stream, leaving the child free to
+     * stats_start() its own file. */
+    if (!atomic_load_explicit(&g_stats_enabled, memory_order_relaxed)) {
+        return;
+    }
+
+    atomic_store_explicit(&g_stats_enabled, false, memory_order_release);
+    atomic_store_explicit(&g_stats_flusher_running, false, memory_order_release);
+
+    if (g_stats_file != NULL) {
+        /* The fd's offset is shared with the parent; point it at
+         * /dev/null before fclose so the child's copy of any buffered
+         * bytes cannot be flushed into the parent's file */
+        int devnull = open("/dev/null", O_WRONLY);
+        if (devnull >= 0) {
+            dup2(devnull, fileno(g_stats_file));
+            close(devnull);
+        }
+        fclose(g_stats_file);
+        g_stats_file = NULL;
+    }
+
+    /* Unflushed records belong to the parent's stream: drop them */
+    StatsRing *ring = atomic_load_explicit(&g_stats_rings, memory_order_acquire);
+    while (ring != NULL) {
+        uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        atomic_store_explicit(&ring->tail, head, memory_order_relaxed);
+        atomic_store_explicit(&ring->dropped, 0, memory_order_relaxed);
+        ring = ring->next;
+    }
+    uint64_t marker_head = atomic_load_explicit(&g_stats_marker_head,
+                                                memory_order_relaxed);
+    atomic_store_explicit(&g_stats_marker_tail, marker_head, memory_order_relaxed);
+}
+
+/* ============================================================================
+ * Capsule API for other extension modules (_setprofile)
+ * ============================================================================ */
+
+#define STATS_API_CAPSULE_NAME "speed_bump._core._STATS_API"
+
+typedef struct {
+    void (*record)(uint64_t code_id, uint64_t delay_ns);
+} SpeedBumpStatsAPI;
+
+static SpeedBumpStatsAPI g_stats_capsule_api = { stats_record };
+
+#endif /* SPEED_BUMP_STATS_H */
@@ -0,0 +1,757 @@
+/*
+ * Speed Bump - Shared timing backend
+ *
+ * Clock calibration and spin-delay primitives shared by _core.c and
+ * _setprofile.c. All state and functions are static, so each translation
+ * unit carries an independent copy: _core calibrates at module init,
+ * _setprofile calibrates lazily at install time. This keeps the two
+ * extension modules importable independently of each other.
+ *
+ * Two timer backends are supported:
+ * - clock_gettime(CLOCK_MONOTONIC): always available, ~20-30ns per read
+ *   via the vDSO on typical hosts.
+ * - Raw cycle counter (x86 rdtsc / aarch64 cntvct_el0): a few ns per
+ *   read, selected at calibration time when the counter is invariant
+ *   (constant rate, unaffected by frequency scaling). The counter
+ *   frequency is measured against CLOCK_MONOTONIC during calibration.
+ *
+ * Thread-safety: calibration state is written once (from module init or
+ * from install under the GIL) and read-only thereafter. spin_delay_ns
+ * uses only local variables and is fully thread-safe.
+ */
+
+#ifndef SPEED_BUMP_TIMING_H
+#define SPEED_BUMP_TIMING_H
+
+#include <time.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/utsname.h>
+
+/* Architecture-specific pause instruction and cycle counter */
+#ifdef __x86_64__
+#include <immintrin.h>
+#include <cpuid.h>
+#define CPU_PAUSE() _mm_pause()
+#elif defined(__aarch64__)
+#define CPU_PAUSE() __asm__ __volatile__("yield")
+#else
+#define CPU_PAUSE() ((void)0)
+#endif
+
+/* ============================================================================
+ * Calibration State
+ * ============================================================================ */
+
+static uint64_t g_clock_overhead_ns = 0;   /* per clock_gettime read */
+static uint64_t g_cycle_overhead_ns = 0;   /* per cycle-counter read */
+static double g_ns_per_cycle = 0.0;        /* measured counter period */
+static bool g_use_cycles = false;          /* cycle backend selected */
+static bool g_calibrated = false;
+static bool g_calibration_loaded = false;  /* state came from the cache file */
+
+/* Delay mode. Pure spin holds a core for the whole delay; hybrid mode
+ * sleeps until shortly before the deadline and spins out the remainder,
+ * trading a little setup cost for not burning CPU on large delays. */
+typedef enum {
+    DELAY_MODE_SPIN = 0,
+    DELAY_MODE_HYBRID = 1,
+} DelayMode;
+
+static DelayMode g_delay_mode = DELAY_MODE_SPIN;
+static uint64_t g_sleep_slack_ns = 0;      /* measured nanosleep overshoot */
+
+/* Delay distribution. Fixed applies the configured delay verbatim; the
+ * stochastic distributions sample each bump's duration with the
+ * configured delay as the mean, so the same total slowdown arrives as
+ * bursty stalls rather than a perfectly periodic one. */
+typedef enum {
+    DELAY_DIST_FIXED = 0,
+    DELAY_DIST_NORMAL = 1,
+    DELAY_DIST_EXPONENTIAL = 2,
+    DELAY_DIST_PARETO = 3,
+} DelayDist;
+
+static DelayDist g_delay_dist = DELAY_DIST_FIXED;
+
+/* Fixed per-bump overhead, subtracted from each requested delay inside
+ * apply_delay_ns so the observed stall matches the requested one
+ * rather than requested-plus-bookkeeping. Split into the delay
+ * dispatch's own cost (sampling plus the spin loop's timer reads,
+ * measured by timing_calibrate_dispatch) and the monitoring callback's
+ * cost (measured by the backend at install time). Without this, small
+ * bumps carry a double-digit-percent systematic overshoot. */
+static uint64_t g_dispatch_overhead_ns = 0;
+static uint64_t g_callback_overhead_ns = 0;
+
+/* ============================================================================
+ * Time Utilities
+ * ============================================================================ */
+
+static inline uint64_t timespec_to_ns(const struct timespec *ts) {
+    return (uint64_t)ts->tv_sec * 1000000000ULL + (uint64_t)ts->tv_nsec;
+}
+
+static inline uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return timespec_to_ns(&ts);
+}
+
+static inline struct timespec ns_to_timespec(uint64_t ns) {
+    struct timespec ts;
+    ts.tv_sec = (time_t)(ns / 1000000000ULL);
+    ts.tv_nsec = (long)(ns % 1000000000ULL);
+    return ts;
+}
+
+static inline uint64_t read_cycles(void) {
+#ifdef __x86_64__
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t value;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    return 0;
+#endif
+}
+
+/* Check whether the cycle counter runs at a constant rate and can be
+ * trusted for wall-time measurement. */
+static inline bool cycle_counter_invariant(void) {
+#ifdef __x86_64__
+    /* CPUID.80000007H:EDX[8] = invariant TSC */
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    return (edx & (1u << 8)) != 0;
+#elif defined(__aarch64__)
+    /* The architectural virtual counter is constant-rate by definition */
+    return true;
+#else
+    return false;
+#endif
+}
+
+/* ============================================================================
+ * Calibration Cache
+ *
+ * Calibration runs 100k+ clock reads, which is pure startup cost when a
+ * launcher spawns dozens of workers on the same host. The result is
+ * cached to a per-host file keyed by kernel release, CPU model and
+ * clocksource; a matching key skips measurement entirely, and a key
+ * mismatch (kernel upgrade, migration, clocksource change) re-measures.
+ *
+ * SPEED_BUMP_CALIBRATION_CACHE overrides the file path ('off' disables
+ * caching); the default is $XDG_CACHE_HOME/speed_bump/calibration,
+ * falling back to ~/.cache/speed_bump/calibration.
+ * ============================================================================ */
+
+#define SB_CALIBRATION_CACHE_VERSION 1
+
+/* Copy the first value of a 'name : value' line matching prefix from a
+ * /proc-style file into buf. Returns false if not found. */
+static bool timing_read_tagged_line(const char *path, const char *prefix,
+                                    char *buf, size_t buflen) {
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        return false;
+    }
+
+    char line[256];
+    bool found = false;
+    while (fgets(line, sizeof(line), f) != NULL) {
+        if (strncmp(line, prefix, strlen(prefix)) != 0) {
+            continue;
+        }
+        const char *colon = strchr(line, ':');
+        if (colon == NULL) {
+            continue;
+        }
+        colon++;
+        while (*colon == ' ' || *colon == '\t') {
+            colon++;
+        }
+        snprintf(buf, buflen, "%s", colon);
+        buf[strcspn(buf, "\n")] = '\0';
+        found = true;
+        break;
+    }
+    fclose(f);
+    return found;
+}
+
+/* Build the host key the cached calibration is valid for:
+ * kernel release | CPU model | current clocksource. */
+static void timing_cache_host_key(char *buf, size_t buflen) {
+    struct utsname un;
+    const char *release = uname(&un) == 0 ? un.release : "unknown";
+
+    char cpu[160];
+    if (!timing_read_tagged_line("/proc/cpuinfo", "model name", cpu, sizeof(cpu)) &&
+        !timing_read_tagged_line("/proc/cpuinfo", "Processor", cpu, sizeof(cpu))) {
+        snprintf(cpu, sizeof(cpu), "unknown");
+    }
+
+    char clocksource[64] = "unknown";
+    FILE *f = fopen("/sys/devices/system/clocksource/clocksource0/current_clocksource", "r");
+    if (f != NULL) {
+        if (fgets(clocksource, sizeof(clocksource), f) != NULL) {
+            clocksource[strcspn(clocksource, "\n")] = '\0';
+        }
+        fclose(f);
+    }
+
+    snprintf(buf, buflen, "%s|%s|%s", release, cpu, clocksource);
+}
+
+/* Resolve the cache file path. Returns false when caching is disabled
+ * (explicitly, or because no home directory could be determined). */
+static bool timing_cache_path(char *buf, size_t buflen) {
+    const char *override = getenv("SPEED_BUMP_CALIBRATION_CACHE");
+    if (override != NULL) {
+        if (*override == '\0' || strcmp(override, "off") == 0) {
+            return false;
+        }
+        snprintf(buf, buflen, "%s", override);
+        return true;
+    }
+
+    const char *xdg = getenv("XDG_CACHE_HOME");
+    if (xdg != NULL && *xdg != '\0') {
+        snprintf(buf, buflen, "%s/speed_bump/calibration", xdg);
+        return true;
+    }
+
+    const char *home = getenv("HOME");
+    if (home != NULL && *home != '\0') {
+        snprintf(buf, buflen, "%s/.cache/speed_bump/calibration", home);
+        return true;
+    }
+    return false;
+}
+
+/* Load cached calibration for this host. Returns true when a valid
+ * cache with a matching key populated the calibration state. */
+static bool timing_cache_load(void) {
+    char path[512];
+    if (!timing_cache_path(path, sizeof(path))) {
+        return false;
+    }
+
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        return false;
+    }
+
+    char host_key[512];
+    timing_cache_host_key(host_key, sizeof(host_key));
+
+    int version = 0;
+    char key[768] = "";
+    unsigned long long clock_oh = 0, cycle_oh = 0, slack = 0, dispatch = 0;
+    double ns_per_cycle = 0.0;
+    int use_cycles = 0;
+    int fields = 0;
+
+    char line[768];
+    while (fgets(line, sizeof(line), f) != NULL) {
+        if (sscanf(line, "version %d", &version) == 1) {
+            fields++;
+        } else if (strncmp(line, "key ", 4) == 0) {
+            snprintf(key, sizeof(key), "%s", line + 4);
+            key[strcspn(key, "\n")] = '\0';
+            fields++;
+        } else if (sscanf(line, "clock_overhead_ns %llu", &clock_oh) == 1 ||
+                   sscanf(line, "cycle_overhead_ns %llu", &cycle_oh) == 1 ||
+                   sscanf(line, "ns_per_cycle %lf", &ns_per_cycle) == 1 ||
+                   sscanf(line, "use_cycles %d", &use_cycles) == 1 ||
+                   sscanf(line, "sleep_slack_ns %llu", &slack) == 1 ||
+                   sscanf(line, "dispatch_overhead_ns %llu", &dispatch) == 1) {
+            fields++;
+        }
+    }
+    fclose(f);
+
+    if (fields != 8 || version != SB_CALIBRATION_CACHE_VERSION ||
+        strcmp(key, host_key) != 0) {
+        return false;  /* Stale, truncated or from another host/kernel */
+    }
+    if (clock_oh == 0 || slack == 0 || (use_cycles && ns_per_cycle <= 0.0)) {
+        return false;  /* Implausible; re-measure */
+    }
+
+    g_clock_overhead_ns = (uint64_t)clock_oh;
+    g_cycle_overhead_ns = (uint64_t)cycle_oh;
+    g_ns_per_cycle = ns_per_cycle;
+    g_use_cycles = use_cycles != 0;
+    g_sleep_slack_ns = (uint64_t)slack;
+    g_dispatch_overhead_ns = (uint64_t)dispatch;
+    return true;
+}
+
+/* Write the current calibration state to the cache file, best effort.
+ * The file is written to a per-pid temporary and renamed so concurrent
+ * workers never see a torn file. */
+static void timing_cache_save(void) {
+    char path[512];
+    if (!timing_cache_path(path, sizeof(path))) {
+        return;
+    }
+
+    /* Create the parent directory (one level; the cache root exists on
+     * any host with a home directory) */
+    char dir[512];
+    snprintf(dir, sizeof(dir), "%s", path);
+    char *slash = strrchr(dir, '/');
+    if (slash != NULL) {
+        *slash = '\0';
+        mkdir(dir, 0755);  /* EEXIST is fine */
+    }
+
+    char host_key[512];
+    timing_cache_host_key(host_key, sizeof(host_key));
+
+    char tmp[560];
+    snprintf(tmp, sizeof(tmp), "%s.%ld", path, (long)getpid());
+    FILE *f = fopen(tmp, "w");
+    if (f == NULL) {
+        return;
+    }
+
+    fprintf(f, "version %d\n", SB_CALIBRATION_CACHE_VERSION);
+    fprintf(f, "key %s\n", host_key);
+    fprintf(f, "clock_overhead_ns %llu\n", (unsigned long long)g_clock_overhead_ns);
+    fprintf(f, "cycle_overhead_ns %llu\n", (unsigned long long)g_cycle_overhead_ns);
+    fprintf(f, "ns_per_cycle %.17g\n", g_ns_per_cycle);
+    fprintf(f, "use_cycles %d\n", g_use_cycles ? 1 : 0);
+    fprintf(f, "sleep_slack_ns %llu\n", (unsigned long long)g_sleep_slack_ns);
+    fprintf(f, "dispatch_overhead_ns %llu\n", (unsigned long long)g_dispatch_overhead_ns);
+
+    if (fclose(f) != 0 || rename(tmp, path) != 0) {
+        unlink(tmp);
+    }
+}
+
+/* ============================================================================
+ * Calibration
+ *
+ * Measures clock_gettime overhead and, when an invariant cycle counter
+ * is available, the counter's read overhead and frequency. Safe to call
+ * more than once; subsequent calls are no-ops. A valid per-host cache
+ * file skips the measurement entirely.
+ * ============================================================================ */
+
+static void timing_measure(void) {
+    struct timespec ts, start, end;
+    const int WARMUP = 1000;
+    const int ITERS = 100000;
+
+    /* Warmup - prime caches and TLB */
+    for (int i = 0; i < WARMUP; i++) {
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+    }
+
+    /* Measure clock_gettime overhead */
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < ITERS; i++) {
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    uint64_t elapsed = timespec_to_ns(&end) - timespec_to_ns(&start);
+    g_clock_overhead_ns = elapsed / ITERS;
+    if (g_clock_overhead_ns == 0) {
+        g_clock_overhead_ns = 1;
+    }
+
+    if (cycle_counter_invariant()) {
+        /* Measure cycle-counter read overhead against the wall clock */
+        volatile uint64_t sink = 0;
+        for (int i = 0; i < WARMUP; i++) {
+            sink += read_cycles();
+        }
+        uint64_t t0 = monotonic_ns();
+        for (int i = 0; i < ITERS; i++) {
+            sink += read_cycles();
+        }
+        uint64_t t1 = monotonic_ns();
+        g_cycle_overhead_ns = (t1 - t0) / ITERS;
+        if (g_cycle_overhead_ns == 0) {
+            g_cycle_overhead_ns = 1;
+        }
+        (void)sink;
+
+        /* Measure counter frequency over a ~5ms window */
+        const uint64_t CAL_WINDOW_NS = 5000000;
+        uint64_t c0 = read_cycles();
+        uint64_t w0 = monotonic_ns();
+        uint64_t w1;
+        do {
+            CPU_PAUSE();
+            w1 = monotonic_ns();
+        } while (w1 - w0 < CAL_WINDOW_NS);
+        uint64_t c1 = read_cycles();
+
+        if (c1 > c0) {
+            g_ns_per_cycle = (double)(w1 - w0) / (double)(c1 - c0);
+            g_use_cycles = true;
+        }
+    }
+
+    /* Measure clock_nanosleep wakeup slack for the hybrid delay mode:
+     * request short absolute sleeps and record the worst overshoot.
+     * Hybrid delays sleep until slack-ns before the deadline and spin
+     * the rest, so this sets the sleep/spin crossover. */
+    {
+        const int SLEEP_ITERS = 5;
+        const uint64_t SLEEP_REQUEST_NS = 100000;  /* 100us */
+        uint64_t worst_overshoot = 0;
+
+        for (int i = 0; i < SLEEP_ITERS; i++) {
+            uint64_t deadline = monotonic_ns() + SLEEP_REQUEST_NS;
+            struct timespec until = ns_to_timespec(deadline);
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL);
+            uint64_t now = monotonic_ns();
+            if (now > deadline && now - deadline > worst_overshoot) {
+                worst_overshoot = now - deadline;
+            }
+        }
+
+        /* Double the worst observed overshoot as margin for scheduling
+         * variance, with a floor of 50us (roughly one timer tick) */
+        g_sleep_slack_ns = 2 * worst_overshoot;
+        if (g_sleep_slack_ns < 50000) {
+            g_sleep_slack_ns = 50000;
+        }
+    }
+}
+
+static void timing_calibrate(void) {
+    if (g_calibrated) {
+        return;
+    }
+
+    if (timing_cache_load()) {
+        g_calibration_loaded = true;
+        g_calibrated = true;
+        return;
+    }
+
+    timing_measure();
+    g_calibrated = true;
+}
+
+/* ============================================================================
+ * Spin Delay
+ * ============================================================================ */
+
+static void spin_delay_ns(uint64_t delay_ns) {
+    if (g_use_cycles) {
+        uint64_t target_cycles = (uint64_t)((double)delay_ns / g_ns_per_cycle);
+        uint64_t start_cycles = read_cycles();
+
+        while (read_cycles() - start_cycles < target_cycles) {
+            CPU_PAUSE();
+        }
+        return;
+    }
+
+    struct timespec start, now;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    uint64_t end_ns = timespec_to_ns(&start) + delay_ns;
+
+    for (;;) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (timespec_to_ns(&now) >= end_ns) {
+            break;
+        }
+        CPU_PAUSE();
+    }
+}
+
+/* ============================================================================
+ * Delay Sampling
+ *
+ * Per-thread xoshiro256** PRNG for the stochastic delay distributions.
+ * Sampling costs a handful of ns, allocates nothing, and needs no
+ * locking: each thread seeds its own state lazily from the monotonic
+ * clock and the address of its thread-local state.
+ * ============================================================================ */
+
+static _Thread_local uint64_t t_rng_state[4];
+static _Thread_local bool t_rng_seeded = false;
+
+static inline uint64_t rng_rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/* splitmix64, used only to expand the seed into the xoshiro state */
+static inline uint64_t rng_splitmix64(uint64_t *state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t rng_next(void) {
+    if (!t_rng_seeded) {
+        uint64_t seed = monotonic_ns() ^ (uint64_t)(uintptr_t)t_rng_state;
+        for (int i = 0; i < 4; i++) {
+            t_rng_state[i] = rng_splitmix64(&seed);
+        }
+        t_rng_seeded = true;
+    }
+
+    uint64_t *s = t_rng_state;
+    uint64_t result = rng_rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rng_rotl(s[3], 45);
+
+    return result;
+}
+
+/* Uniform double in (0, 1]: 53 random bits, never exactly zero so it is
+ * safe as a log() argument */
+static inline double rng_uniform(void) {
+    return ((double)(rng_next() >> 11) + 1.0) * 0x1.0p-53;
+}
+
+/* Sample one bump duration from the configured distribution with the
+ * given mean. Sampled delays are capped at 64x the mean so a deep
+ * Pareto tail cannot stall a run for seconds on a single bump. */
+static uint64_t sample_delay_ns(uint64_t mean_ns) {
+    double sampled;
+
+    switch (g_delay_dist) {
+    case DELAY_DIST_NORMAL: {
+        /* Box-Muller; sigma is mean/4 so negative samples are rare and
+         * clamping to zero barely shifts the achieved mean */
+        double u1 = rng_uniform();
+        double u2 = rng_uniform();
+        double z = sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+        sampled = (double)mean_ns * (1.0 + 0.25 * z);
+        break;
+    }
+    case DELAY_DIST_EXPONENTIAL:
+        sampled = -(double)mean_ns * log(rng_uniform());
+        break;
+    case DELAY_DIST_PARETO: {
+        /* alpha = 2: finite mean, heavy enough tail to be bursty.
+         * Scale x_m = mean * (alpha - 1) / alpha gives the target mean. */
+        double xm = (double)mean_ns * 0.5;
+        sampled = xm / sqrt(rng_uniform());
+        break;
+    }
+    case DELAY_DIST_FIXED:
+    default:
+        return mean_ns;
+    }
+
+    if (sampled <= 0.0) {
+        return 0;
+    }
+    double cap = (double)mean_ns * 64.0;
+    if (sampled > cap) {
+        sampled = cap;
+    }
+    return (uint64_t)sampled;
+}
+
+/* Parse a distribution name into the TU-local distribution.
+ * Returns 0 on success, -1 on an unknown name. */
+static int timing_set_delay_dist(const char *dist) {
+    if (strcmp(dist, "fixed") == 0) {
+        g_delay_dist = DELAY_DIST_FIXED;
+        return 0;
+    }
+    if (strcmp(dist, "normal") == 0) {
+        g_delay_dist = DELAY_DIST_NORMAL;
+        return 0;
+    }
+    if (strcmp(dist, "exponential") == 0) {
+        g_delay_dist = DELAY_DIST_EXPONENTIAL;
+        return 0;
+    }
+    if (strcmp(dist, "pareto") == 0) {
+        g_delay_dist = DELAY_DIST_PARETO;
+        return 0;
+    }
+    return -1;
+}
+
+static inline const char* timing_delay_dist_name(void) {
+    switch (g_delay_dist) {
+    case DELAY_DIST_NORMAL: return "normal";
+    case DELAY_DIST_EXPONENTIAL: return "exponential";
+    case DELAY_DIST_PARETO: return "pareto";
+    case DELAY_DIST_FIXED:
+    default: return "fixed";
+    }
+}
+
+/* ============================================================================
+ * Delay Dispatch
+ *
+ * apply_delay_ns is the entry point the monitoring backends use. The
+ * requested delay is first passed through the configured distribution
+ * (a no-op for "fixed"), and the sampled duration is returned so
+ * callers can record what was actually applied. In hybrid mode, delays
+ * comfortably above the measured sleep slack clock_nanosleep until
+ * slack-ns before the deadline and spin out the remainder, keeping spin
+ * accuracy while cutting CPU burn on large delays. Delays below the
+ * crossover always spin.
+ * ============================================================================ */
+
+static uint64_t apply_delay_ns(uint64_t mean_delay_ns) {
+    uint64_t delay_ns = sample_delay_ns(mean_delay_ns);
+
+    /* Compensate for the fixed per-bump cost: the callback and delay
+     * machinery already stall the caller by the measured overhead, so
+     * only the remainder is actively waited out. The uncompensated
+     * (intended) duration is still what gets returned and recorded. */
+    uint64_t overhead = g_dispatch_overhead_ns + g_callback_overhead_ns;
+    uint64_t wait_ns = delay_ns > overhead ? delay_ns - overhead : 0;
+    if (wait_ns == 0) {
+        return delay_ns;
+    }
+
+    if (g_delay_mode == DELAY_MODE_HYBRID && wait_ns > 2 * g_sleep_slack_ns) {
+        uint64_t deadline = monotonic_ns() + wait_ns;
+        struct timespec until = ns_to_timespec(deadline - g_sleep_slack_ns);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL);
+
+        while (monotonic_ns() < deadline) {
+            CPU_PAUSE();
+        }
+        return delay_ns;
+    }
+
+    spin_delay_ns(wait_ns);
+    return delay_ns;
+}
+
+/* Measure the fixed cost of the delay dispatch itself - distribution
+ * sampling plus the spin loop's entry timer reads - by timing
+ * zero-length applies. Called once by each backend straight after
+ * timing_calibrate, while the distribution is still 'fixed'. */
+static void timing_calibrate_dispatch(void) {
+    const int ITERS = 10000;
+
+    if (g_dispatch_overhead_ns != 0) {
+        return;
+    }
+
+    uint64_t t0 = monotonic_ns();
+    for (int i = 0; i < ITERS; i++) {
+        spin_delay_ns(sample_delay_ns(0));
+    }
+    uint64_t t1 = monotonic_ns();
+    g_dispatch_overhead_ns = (t1 - t0) / ITERS;
+    if (g_dispatch_overhead_ns == 0) {
+        g_dispatch_overhead_ns = 1;
+    }
+
+    /* Dispatch overhead completes a fresh calibration; persist it so
+     * the next interpreter on this host skips measurement entirely */
+    if (!g_calibration_loaded) {
+        timing_cache_save();
+    }
+}
+
+/* Throw away the current (possibly cached) calibration, re-measure and
+ * rewrite the cache file. The measured callback overhead is kept: it
+ * belongs to the installed monitoring backend, not to the host clock. */
+static void timing_recalibrate(void) {
+    g_calibrated = false;
+    g_calibration_loaded = false;
+    g_clock_overhead_ns = 0;
+    g_cycle_overhead_ns = 0;
+    g_ns_per_cycle = 0.0;
+    g_use_cycles = false;
+    g_sleep_slack_ns = 0;
+    g_dispatch_overhead_ns = 0;
+
+    timing_measure();
+    g_calibrated = true;
+    timing_calibrate_dispatch();  /* also rewrites the cache */
+}
+
+/* Parse a delay mode name ("spin" or "hybrid") into the TU-local mode.
+ * Returns 0 on success, -1 on an unknown name. */
+static int timing_set_delay_mode(const char *mode) {
+    if (strcmp(mode, "spin") == 0) {
+        g_delay_mode = DELAY_MODE_SPIN;
+        return 0;
+    }
+    if (strcmp(mode, "hybrid") == 0) {
+        g_delay_mode = DELAY_MODE_HYBRID;
+        return 0;
+    }
+    return -1;
+}
+
+/* ============================================================================
+ * Introspection
+ * ============================================================================ */
+
+/* Per-read overhead of the timer the spin loop actually uses */
+static inline uint64_t timing_read_overhead_ns(void) {
+    return g_use_cycles ? g_cycle_overhead_ns : g_clock_overhead_ns;
+}
+
+/* Whether the current calibration came from the per-host cache file
+ * rather than being measured in this process */
+static inline bool timing_calibration_loaded(void) {
+    return g_calibration_loaded;
+}
+
+/* Total fixed per-bump overhead currently subtracted from each
+ * requested delay by apply_delay_ns */
+static inline uint64_t timing_bump_overhead_ns(void) {
+    return g_dispatch_overhead_ns + g_callback_overhead_ns;
+}
+
+/* Record the measured per-bump cost of the active monitoring callback.
+ * Set by the backend at install time; the measurement itself happens
+ * in Python, where a probe function can be timed with and without the
+ * callback attached. */
+static inline void timing_set_callback_overhead_ns(uint64_t overhead_ns) {
+    g_callback_overhead_ns = overhead_ns;
+}
+
+/* Minimum achievable delay: the spin loop needs at least two timer
+ * reads (start and end) */
+static inline uint64_t timing_min_delay_ns(void) {
+    return 2 * timing_read_overhead_ns();
+}
+
+static inline const char* timing_backend_name(void) {
+    if (!g_use_cycles) {
+        return "clock_gettime";
+    }
+#ifdef __x86_64__
+    return "tsc";
+#elif defined(__aarch64__)
+    return "cntvct";
+#else
+    return "clock_gettime";
+#endif
+}
+
+#endif /* SPEED_BUMP_TIMING_H */
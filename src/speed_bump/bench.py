@@ -0,0 +1,235 @@
+"""Overhead benchmark suite: quantify speed-bump's own observer effect.
+
+Measures the costs that determine our measurement error bars, emitting
+machine-readable JSON so results can be diffed across versions and
+backends:
+
+- Per-call cost of a non-matching function under an active install
+  (after DISABLE / cached no-match), against an uninstalled baseline.
+- Per-call cost of a matching function at zero requested delay, i.e.
+  the dispatch overhead added on top of every injected delay.
+- First-call classification cost as the targets file grows.
+- spin_delay_ns accuracy across delay magnitudes.
+
+Run via the ``speed-bump-bench`` console script, or from a checkout:
+
+    python benchmarks/bench_overhead.py [--output results.json]
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import sys
+import time
+
+import speed_bump
+from speed_bump import Config, clear_cache, install, spin_delay_ns, uninstall
+from speed_bump._monitoring import _USE_PEP669
+from speed_bump._patterns import parse_pattern
+
+# Loop sizes, chosen so each measurement takes tens of milliseconds
+_CALL_ITERATIONS = 200_000
+_FRESH_FUNCTIONS = 200
+_PATTERN_COUNTS = (1, 10, 100, 500)
+_SPIN_DELAYS_NS = (100, 1_000, 10_000, 100_000, 1_000_000)
+
+
+def _bench_target() -> int:
+    return 42
+
+
+def _per_call_ns(fn, iterations: int = _CALL_ITERATIONS) -> float:
+    """Mean per-call wall time of fn over a tight loop."""
+    start = time.perf_counter_ns()
+    for _ in range(iterations):
+        fn()
+    return (time.perf_counter_ns() - start) / iterations
+
+
+def _make_config(patterns: list[str], delay_ns: int = 0) -> Config:
+    """Build an active-window Config from pattern strings."""
+    return Config(
+        enabled=True,
+        targets=tuple(
+            parse_pattern(line, i + 1) for i, line in enumerate(patterns)
+        ),
+        delay_ns=delay_ns,
+        frequency=1,
+        start_ns=time.time_ns() - 1_000_000_000,
+        end_ns=None,
+    )
+
+
+def _make_fresh_functions(count: int) -> list:
+    """Create distinct, never-called functions (fresh code objects)."""
+    namespace: dict = {}
+    source = "\n".join(
+        f"def _bench_fresh_{i}():\n    return {i}" for i in range(count)
+    )
+    exec(source, namespace)  # noqa: S102 - our own generated source
+    return [namespace[f"_bench_fresh_{i}"] for i in range(count)]
+
+
+def bench_non_matching() -> dict:
+    """Per-call cost of a non-matching function, installed vs not."""
+    baseline_ns = _per_call_ns(_bench_target)
+
+    install(_make_config(["zzz_no_such_module:zzz_no_such_function"]))
+    try:
+        _bench_target()  # classify (DISABLE / cached no-match)
+        with_install_ns = _per_call_ns(_bench_target)
+    finally:
+        uninstall()
+        clear_cache()
+
+    return {
+        "baseline_ns": round(baseline_ns, 2),
+        "with_install_ns": round(with_install_ns, 2),
+        "overhead_ns": round(with_install_ns - baseline_ns, 2),
+    }
+
+
+def bench_matching() -> dict:
+    """Per-call dispatch cost of a matching function at zero delay."""
+    baseline_ns = _per_call_ns(_bench_target)
+
+    install(_make_config(["*:_bench_target"], delay_ns=0))
+    try:
+        _bench_target()  # classify
+        per_call_ns = _per_call_ns(_bench_target)
+    finally:
+        uninstall()
+        clear_cache()
+
+    return {
+        "requested_delay_ns": 0,
+        "per_call_ns": round(per_call_ns, 2),
+        "overhead_ns": round(per_call_ns - baseline_ns, 2),
+    }
+
+
+def bench_classification() -> list[dict]:
+    """First-call classification cost against targets-file size.
+
+    All patterns miss, so every fresh function walks the whole table.
+    """
+    results = []
+    for pattern_count in _PATTERN_COUNTS:
+        patterns = [
+            f"zzz_module_{i}.*:zzz_function_{i}_*" for i in range(pattern_count)
+        ]
+        functions = _make_fresh_functions(_FRESH_FUNCTIONS)
+
+        install(_make_config(patterns))
+        try:
+            start = time.perf_counter_ns()
+            for fn in functions:
+                fn()
+            elapsed = time.perf_counter_ns() - start
+        finally:
+            uninstall()
+            clear_cache()
+
+        results.append(
+            {
+                "patterns": pattern_count,
+                "first_call_ns": round(elapsed / _FRESH_FUNCTIONS, 2),
+            }
+        )
+    return results
+
+
+def bench_spin_accuracy() -> list[dict]:
+    """spin_delay_ns accuracy across delay magnitudes."""
+    results = []
+    for requested_ns in _SPIN_DELAYS_NS:
+        # Aim for ~50ms of total spinning per magnitude
+        iterations = max(10, min(10_000, 50_000_000 // requested_ns))
+        start = time.perf_counter_ns()
+        for _ in range(iterations):
+            spin_delay_ns(requested_ns)
+        measured_ns = (time.perf_counter_ns() - start) / iterations
+
+        error_ns = measured_ns - requested_ns
+        results.append(
+            {
+                "requested_ns": requested_ns,
+                "measured_ns": round(measured_ns, 2),
+                "error_ns": round(error_ns, 2),
+                "error_pct": round(100.0 * error_ns / requested_ns, 3),
+            }
+        )
+    return results
+
+
+def _backend_name() -> str:
+    if not _USE_PEP669:
+        return "setprofile"
+    from speed_bump._monitoring import _HAVE_NATIVE_HANDLER
+
+    return "pep669-native" if _HAVE_NATIVE_HANDLER else "pep669-python"
+
+
+def run_all() -> dict:
+    """Run the full suite and return the results document."""
+    gil_enabled = (
+        sys._is_gil_enabled() if hasattr(sys, "_is_gil_enabled") else True
+    )
+    return {
+        "meta": {
+            "timestamp": time.strftime("%Y-%m-%dT%H:%M:%S%z"),
+            "python": sys.version.split()[0],
+            "backend": _backend_name(),
+            "gil_enabled": gil_enabled,
+            "speed_bump_version": speed_bump.__version__,
+            "timer_backend": speed_bump.get_timer_backend(),
+            "clock_overhead_ns": speed_bump.clock_overhead_ns,
+            "min_delay_ns": speed_bump.min_delay_ns,
+            "bump_overhead_ns": speed_bump.get_bump_overhead_ns(),
+            "call_iterations": _CALL_ITERATIONS,
+        },
+        "results": {
+            "non_matching": bench_non_matching(),
+            "matching": bench_matching(),
+            "classification": bench_classification(),
+            "spin_accuracy": bench_spin_accuracy(),
+        },
+    }
+
+
+def main(argv: list[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(
+        prog="speed-bump-bench",
+        description="Measure speed-bump's own per-call overhead.",
+    )
+    parser.add_argument(
+        "--output",
+        "-o",
+        help="Write JSON results to this file (default: stdout)",
+    )
+    args = parser.parse_args(argv)
+
+    document = run_all()
+    rendered = json.dumps(document, indent=2)
+
+    if args.output:
+        with open(args.output, "w", encoding="utf-8") as f:
+            f.write(rendered + "\n")
+        print(f"speed-bump-bench: wrote {args.output}", file=sys.stderr)
+    else:
+        print(rendered)
+
+    # Human-readable summary on stderr so stdout stays machine-readable
+    results = document["results"]
+    print(
+        f"speed-bump-bench: backend={document['meta']['backend']} "
+        f"non-matching overhead={results['non_matching']['overhead_ns']}ns/call "
+        f"matching dispatch={results['matching']['overhead_ns']}ns/call",
+        file=sys.stderr,
+    )
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
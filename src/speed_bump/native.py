@@ -4,7 +4,10 @@ This module provides a Python API to control the speed-bump kernel module's
 native uprobe functionality with per-process filtering.
 
 The kernel module must be loaded and the sysfs interface must be available
-at /sys/kernel/speed_bump/targets for this module to work.
+at /sys/kernel/speed_bump/targets for this module to work. Modules that
+also expose /sys/kernel/speed_bump/stats report per-probe hit counts,
+readable through stats() or probe(report=True), so a mistyped symbol
+shows up as zero hits instead of a silent "no sensitivity" result.
 
 Example:
     >>> from speed_bump import native
@@ -15,11 +18,48 @@ Example:
     ...     run_benchmark()
 """
 
+import dataclasses
+import fnmatch
+import hashlib
+import mmap
 import os
 import contextlib
-from typing import Optional, Generator
+import struct
+import sys
+from typing import Iterable, Optional, Generator, Sequence, Union
 
 SYSFS_TARGETS = "/sys/kernel/speed_bump/targets"
+SYSFS_STATS = "/sys/kernel/speed_bump/stats"
+
+# On-disk symbol index cache, keyed by (path, mtime, size) so a
+# rebuilt binary invalidates its entry automatically
+SYMBOL_CACHE_DIR = os.path.join(
+    os.environ.get("XDG_CACHE_HOME", os.path.expanduser("~/.cache")),
+    "speed_bump",
+    "symbols",
+)
+
+# Characters that make a symbol a glob pattern rather than a name
+_GLOB_CHARS = frozenset("*?[")
+
+# A probe spec for the batch API: (binary_path, symbol) using the shared
+# delay, or (binary_path, symbol, delay_ns) to override it per probe.
+ProbeSpec = Union[tuple[str, str], tuple[str, str, int]]
+
+
+@dataclasses.dataclass(frozen=True, slots=True)
+class ProbeStats:
+    """Per-probe statistics reported by the kernel module."""
+
+    binary_path: str
+    symbol: str
+    hits: int
+    total_delay_ns: int
+
+
+def _warn(message: str) -> None:
+    """Print a warning to stderr."""
+    print(f"speed_bump: WARNING: {message}", file=sys.stderr)
 
 
 def _write_target(spec: str) -> None:
@@ -43,15 +83,28 @@ def add_probe(
 ) -> None:
     """Add a probe for a native function.
 
+    The symbol may be a glob pattern (e.g. 'cudaLaunch*'), in which
+    case it is expanded against the binary's dynamic symbol table and
+    all matches are added with a single batched sysfs write.
+
     Args:
         binary_path: Path to the binary containing the symbol.
-        symbol: The symbol name to probe.
+        symbol: The symbol name or glob pattern to probe.
         delay_ns: Delay in nanoseconds to inject (default: 0).
         pid: Process ID to filter (default: current process).
 
     Raises:
         OSError: If the sysfs interface is not available or write fails.
+        ValueError: If a glob pattern matches no symbols or the binary
+            cannot be parsed.
     """
+    if _GLOB_CHARS & set(symbol):
+        add_probes(
+            [(binary_path, s) for s in _expand_or_raise(binary_path, symbol)],
+            delay_ns,
+            pid,
+        )
+        return
     if pid is None:
         pid = os.getpid()
     spec = f"+{binary_path}:{symbol} {delay_ns} pid={pid}"
@@ -61,13 +114,23 @@ def add_probe(
 def remove_probe(binary_path: str, symbol: str) -> None:
     """Remove a probe for a native function.
 
+    Glob patterns are expanded the same way as in add_probe(), so the
+    pair tears down exactly what it set up.
+
     Args:
         binary_path: Path to the binary containing the symbol.
-        symbol: The symbol name to remove.
+        symbol: The symbol name or glob pattern to remove.
 
     Raises:
         OSError: If the sysfs interface is not available or write fails.
+        ValueError: If a glob pattern matches no symbols or the binary
+            cannot be parsed.
     """
+    if _GLOB_CHARS & set(symbol):
+        remove_probes(
+            [(binary_path, s) for s in _expand_or_raise(binary_path, symbol)]
+        )
+        return
     spec = f"-{binary_path}:{symbol}"
     _write_target(spec)
 
@@ -78,20 +141,30 @@ def probe(
     symbol: str,
     delay_ns: int = 0,
     pid: Optional[int] = None,
-) -> Generator[None, None, None]:
+    report: bool = False,
+) -> Generator[Optional[dict], None, None]:
     """Context manager for scoped native probing.
 
     Adds a probe on entry and removes it on exit, ensuring cleanup
-    even if an exception occurs.
+    even if an exception occurs. Glob symbols expand against the
+    binary's symbol index, probing every match.
+
+    With report=True, the yielded dict is filled with per-symbol hit
+    counts (read from the stats interface just before the probe is
+    removed), and a probe that never fired - a mistyped symbol, or a
+    binary that was never called - is warned about instead of silently
+    producing a "no sensitivity" result.
 
     Args:
         binary_path: Path to the binary containing the symbol.
-        symbol: The symbol name to probe.
+        symbol: The symbol name or glob pattern to probe.
         delay_ns: Delay in nanoseconds to inject (default: 0).
         pid: Process ID to filter (default: current process).
+        report: Collect hit counts on exit (default: False).
 
     Yields:
-        None
+        A dict populated with {symbol: hits} on exit when report=True,
+        None otherwise.
 
     Example:
         >>> with native.probe("/usr/bin/python3", "PyObject_GetAttr", delay_ns=1000):
@@ -99,12 +172,364 @@ def probe(
         ...     pass
     """
     add_probe(binary_path, symbol, delay_ns, pid)
+    hits: Optional[dict] = {} if report else None
     try:
-        yield
+        yield hits
     finally:
+        if report:
+            # Read before removal: the module drops a probe's counters
+            # when the probe is torn down
+            try:
+                for entry in stats(binary_path, symbol):
+                    hits[entry.symbol] = entry.hits
+            except OSError:
+                _warn(
+                    f"probe stats unavailable at {SYSFS_STATS} "
+                    f"(kernel module without stats support?)"
+                )
+            else:
+                if not any(hits.values()):
+                    _warn(f"probe {binary_path}:{symbol} recorded no hits")
         remove_probe(binary_path, symbol)
 
 
+def _normalize_specs(
+    specs: Iterable[ProbeSpec],
+    delay_ns: int,
+) -> list[tuple[str, str, int]]:
+    """Expand batch probe specs into (binary_path, symbol, delay_ns) triples.
+
+    Raises:
+        ValueError: If a spec is not a 2- or 3-tuple.
+    """
+    normalized = []
+    for spec in specs:
+        if len(spec) == 2:
+            binary_path, symbol = spec
+            normalized.append((binary_path, symbol, delay_ns))
+        elif len(spec) == 3:
+            normalized.append(tuple(spec))
+        else:
+            raise ValueError(
+                f"probe spec must be (binary_path, symbol) or "
+                f"(binary_path, symbol, delay_ns), got {spec!r}"
+            )
+    return normalized
+
+
+def add_probes(
+    specs: Iterable[ProbeSpec],
+    delay_ns: int = 0,
+    pid: Optional[int] = None,
+) -> None:
+    """Add many probes with a single sysfs write.
+
+    Joining the specs into one batch block means the kernel module
+    parses one write instead of one per symbol - with hundreds of
+    probes (e.g. all PyObject_* plus all cuda* launch wrappers), per-
+    probe writes would dominate short measurement windows.
+
+    Args:
+        specs: Iterable of (binary_path, symbol) or
+            (binary_path, symbol, delay_ns) tuples.
+        delay_ns: Delay for specs without their own (default: 0).
+        pid: Process ID to filter (default: current process).
+
+    Raises:
+        OSError: If the sysfs interface is not available or write fails.
+        ValueError: If a spec is malformed.
+    """
+    batch = format_add_batch(specs, delay_ns, pid)
+    if batch:
+        _write_target(batch)
+
+
+def remove_probes(specs: Iterable[ProbeSpec]) -> None:
+    """Remove many probes with a single sysfs write.
+
+    Args:
+        specs: Iterable of (binary_path, symbol[, delay_ns]) tuples;
+            any per-spec delay is ignored for removal.
+
+    Raises:
+        OSError: If the sysfs interface is not available or write fails.
+        ValueError: If a spec is malformed.
+    """
+    batch = format_remove_batch(specs)
+    if batch:
+        _write_target(batch)
+
+
+@contextlib.contextmanager
+def probe_set(
+    specs: Sequence[ProbeSpec],
+    delay_ns: int = 0,
+    pid: Optional[int] = None,
+) -> Generator[None, None, None]:
+    """Context manager for a scoped set of native probes.
+
+    Adds all probes with one sysfs write on entry and removes them
+    with one write on exit, ensuring cleanup even if an exception
+    occurs.
+
+    Args:
+        specs: Sequence of (binary_path, symbol) or
+            (binary_path, symbol, delay_ns) tuples.
+        delay_ns: Delay for specs without their own (default: 0).
+        pid: Process ID to filter (default: current process).
+
+    Yields:
+        None
+
+    Example:
+        >>> with native.probe_set(
+        ...     [("/usr/bin/python3", "PyObject_GetAttr"),
+        ...      ("/usr/bin/python3", "PyObject_SetAttr", 5000)],
+        ...     delay_ns=1000,
+        ... ):
+        ...     run_benchmark()
+    """
+    add_probes(specs, delay_ns, pid)
+    try:
+        yield
+    finally:
+        remove_probes(specs)
+
+
+# ============================================================================
+# Probe Statistics
+#
+# The kernel module exposes per-probe counters at
+# /sys/kernel/speed_bump/stats, one line per live probe (the format is
+# coordinated with the speed-bump-native-kmod project):
+#
+#     /path/to/binary:symbol hits=N total_delay_ns=M
+#
+# Counters accumulate while the probe is attached and are dropped when
+# it is removed, so reads must happen before teardown.
+# ============================================================================
+
+
+def parse_stats(text: str) -> "list[ProbeStats]":
+    """Parse the kernel module's stats report.
+
+    Useful for testing or debugging without reading from sysfs. Blank
+    lines, comment lines and lines that do not parse are skipped - the
+    read path must not fall over on a report from a newer module that
+    appends fields or diagnostics.
+
+    Args:
+        text: The raw contents of the stats file.
+
+    Returns:
+        One ProbeStats entry per parsed line, in file order.
+    """
+    entries = []
+    for line in text.splitlines():
+        line = line.strip()
+        if not line or line.startswith("#"):
+            continue
+        fields = line.split()
+        if len(fields) < 3 or ":" not in fields[0]:
+            continue
+        binary_path, _, symbol = fields[0].rpartition(":")
+        values = {}
+        for field in fields[1:]:
+            key, sep, value = field.partition("=")
+            if sep:
+                values[key] = value
+        try:
+            hits = int(values["hits"])
+            total_delay_ns = int(values["total_delay_ns"])
+        except (KeyError, ValueError):
+            continue
+        entries.append(ProbeStats(binary_path, symbol, hits, total_delay_ns))
+    return entries
+
+
+def stats(
+    binary_path: Optional[str] = None,
+    symbol: Optional[str] = None,
+) -> "list[ProbeStats]":
+    """Read per-probe hit statistics from the kernel module.
+
+    Args:
+        binary_path: Only report probes on this binary (default: all).
+        symbol: Only report matching symbols; globs expand with the
+            same fnmatch semantics as probe patterns (default: all).
+
+    Returns:
+        One ProbeStats entry per live probe, in file order.
+
+    Raises:
+        OSError: If the stats interface is not available (module not
+            loaded, or a module built without stats support).
+    """
+    with open(SYSFS_STATS) as f:
+        entries = parse_stats(f.read())
+    if binary_path is not None:
+        entries = [e for e in entries if e.binary_path == binary_path]
+    if symbol is not None:
+        entries = [e for e in entries if fnmatch.fnmatchcase(e.symbol, symbol)]
+    return entries
+
+
+# ============================================================================
+# ELF Symbol Index
+#
+# Parses the dynamic symbol table (.dynsym) directly instead of shelling
+# out to nm: the binary is mmap'd, section headers are walked to find
+# SHT_DYNSYM and its string table, and defined function symbols are
+# collected. The index is cached to disk keyed by (path, mtime, size),
+# so repeated wildcard expansion costs one small file read.
+# ============================================================================
+
+_SHT_DYNSYM = 11
+_STT_FUNC = 2
+_SHN_UNDEF = 0
+
+
+def _parse_dynsym(buf) -> "list[str]":
+    """Extract defined function symbol names from an ELF image.
+
+    Supports little-endian 32- and 64-bit ELF (x86_64, aarch64, ...).
+
+    Raises:
+        ValueError: If the image is not a supported ELF binary.
+    """
+    if buf[:4] != b"\x7fELF":
+        raise ValueError("not an ELF binary")
+
+    ei_class = buf[4]
+    ei_data = buf[5]
+    if ei_data != 1:
+        raise ValueError("big-endian ELF is not supported")
+
+    if ei_class == 2:  # ELFCLASS64
+        (e_shoff,) = struct.unpack_from("<Q", buf, 0x28)
+        e_shentsize, e_shnum = struct.unpack_from("<HH", buf, 0x3A)
+        sym_size = 24
+    elif ei_class == 1:  # ELFCLASS32
+        (e_shoff,) = struct.unpack_from("<I", buf, 0x20)
+        e_shentsize, e_shnum = struct.unpack_from("<HH", buf, 0x2E)
+        sym_size = 16
+    else:
+        raise ValueError("unrecognised ELF class")
+
+    # Walk the section headers: (type, offset, size, link) per section
+    sections = []
+    for i in range(e_shnum):
+        base = e_shoff + i * e_shentsize
+        (sh_type,) = struct.unpack_from("<I", buf, base + 4)
+        if ei_class == 2:
+            sh_offset, sh_size = struct.unpack_from("<QQ", buf, base + 0x18)
+            (sh_link,) = struct.unpack_from("<I", buf, base + 0x28)
+        else:
+            sh_offset, sh_size, sh_link = struct.unpack_from("<III", buf, base + 0x10)
+        sections.append((sh_type, sh_offset, sh_size, sh_link))
+
+    symbols: set[str] = set()
+    for sh_type, sh_offset, sh_size, sh_link in sections:
+        if sh_type != _SHT_DYNSYM:
+            continue
+
+        _, str_offset, str_size, _ = sections[sh_link]
+
+        for entry in range(sh_offset, sh_offset + sh_size, sym_size):
+            if ei_class == 2:
+                st_name, st_info, _, st_shndx = struct.unpack_from("<IBBH", buf, entry)
+            else:
+                st_name, _, _, st_info, _, st_shndx = struct.unpack_from(
+                    "<IIIBBH", buf, entry
+                )
+
+            # Only defined function symbols are probeable
+            if (st_info & 0xF) != _STT_FUNC or st_shndx == _SHN_UNDEF:
+                continue
+            if st_name == 0 or st_name >= str_size:
+                continue
+
+            name_start = str_offset + st_name
+            name_end = buf.find(b"\x00", name_start, str_offset + str_size)
+            if name_end > name_start:
+                symbols.add(buf[name_start:name_end].decode("utf-8", "replace"))
+
+    return sorted(symbols)
+
+
+def _symbol_cache_path(binary_path: str) -> str:
+    """Cache file path for a binary, keyed by (path, mtime, size)."""
+    st = os.stat(binary_path)
+    key = hashlib.sha256(os.path.realpath(binary_path).encode()).hexdigest()[:16]
+    return os.path.join(
+        SYMBOL_CACHE_DIR, f"{key}-{st.st_mtime_ns}-{st.st_size}.syms"
+    )
+
+
+def list_symbols(binary_path: str) -> "list[str]":
+    """List the defined function symbols in a binary's dynamic table.
+
+    The first call parses the ELF and writes the index to the disk
+    cache; later calls (from any process) read the cached index as
+    long as the binary's mtime and size are unchanged.
+
+    Args:
+        binary_path: Path to the ELF binary or shared library.
+
+    Returns:
+        Sorted list of symbol names.
+
+    Raises:
+        OSError: If the binary cannot be read.
+        ValueError: If the binary is not a supported ELF file.
+    """
+    cache_path = _symbol_cache_path(binary_path)
+    try:
+        with open(cache_path, encoding="utf-8") as f:
+            return f.read().splitlines()
+    except OSError:
+        pass
+
+    with open(binary_path, "rb") as f:
+        with mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as buf:
+            symbols = _parse_dynsym(buf)
+
+    # Write the cache atomically so concurrent processes never see a
+    # partial index
+    os.makedirs(SYMBOL_CACHE_DIR, exist_ok=True)
+    tmp_path = f"{cache_path}.{os.getpid()}.tmp"
+    try:
+        with open(tmp_path, "w", encoding="utf-8") as f:
+            f.write("\n".join(symbols))
+        os.replace(tmp_path, cache_path)
+    except OSError:
+        pass  # Cache is best-effort; the parsed index is still valid
+
+    return symbols
+
+
+def expand_symbols(binary_path: str, pattern: str) -> "list[str]":
+    """Expand a glob pattern against a binary's symbol index.
+
+    Args:
+        binary_path: Path to the ELF binary or shared library.
+        pattern: Glob pattern with the same semantics as _patterns.py
+            target globs (fnmatch: *, ? and [seq]).
+
+    Returns:
+        Sorted list of matching symbol names (possibly empty).
+    """
+    return [s for s in list_symbols(binary_path) if fnmatch.fnmatchcase(s, pattern)]
+
+
+def _expand_or_raise(binary_path: str, pattern: str) -> "list[str]":
+    """Expand a glob pattern, raising if nothing matches."""
+    symbols = expand_symbols(binary_path, pattern)
+    if not symbols:
+        raise ValueError(f"no symbols matching '{pattern}' in {binary_path}")
+    return symbols
+
+
 def is_available() -> bool:
     """Check if the kernel module sysfs interface is available.
 
@@ -138,6 +563,47 @@ def format_add_spec(
     return f"+{binary_path}:{symbol} {delay_ns} pid={pid}"
 
 
+def format_add_batch(
+    specs: Iterable[ProbeSpec],
+    delay_ns: int = 0,
+    pid: Optional[int] = None,
+) -> str:
+    """Format a batch of add probe specifications as one block.
+
+    One '+' line per probe, newline-joined, suitable for a single
+    sysfs write. Useful for testing or debugging without writing.
+
+    Args:
+        specs: Iterable of (binary_path, symbol[, delay_ns]) tuples.
+        delay_ns: Delay for specs without their own (default: 0).
+        pid: Process ID to filter (default: current process).
+
+    Returns:
+        The formatted batch block ('' for an empty batch).
+    """
+    if pid is None:
+        pid = os.getpid()
+    return "\n".join(
+        f"+{binary_path}:{symbol} {spec_delay} pid={pid}"
+        for binary_path, symbol, spec_delay in _normalize_specs(specs, delay_ns)
+    )
+
+
+def format_remove_batch(specs: Iterable[ProbeSpec]) -> str:
+    """Format a batch of remove probe specifications as one block.
+
+    Args:
+        specs: Iterable of (binary_path, symbol[, delay_ns]) tuples.
+
+    Returns:
+        The formatted batch block ('' for an empty batch).
+    """
+    return "\n".join(
+        f"-{binary_path}:{symbol}"
+        for binary_path, symbol, _ in _normalize_specs(specs, 0)
+    )
+
+
 def format_remove_spec(binary_path: str, symbol: str) -> str:
     """Format a remove probe specification string.
 
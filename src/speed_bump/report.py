@@ -0,0 +1,246 @@
+"""Offline analysis of speed-bump statistics files.
+
+The speed-bump-report console entry point memory-maps a statistics file
+and streams over its fixed-width records, producing per-code-object hit
+counts and delay totals plus a throughput-vs-phase table when a delay
+sweep was active. A 10-minute run at high bump rates is hundreds of
+millions of records; everything here is a constant-memory pass over the
+mapping, so report time is bounded by read bandwidth, not by building
+Python objects per record.
+
+Example:
+    $ speed-bump-report bumps.bin
+    $ speed-bump-report --top 10 stats.12345.bin
+"""
+
+from __future__ import annotations
+
+import argparse
+import bisect
+import mmap
+import os
+import sys
+from collections import Counter
+
+from speed_bump.stats import (
+    _HEADER,
+    _RECORD,
+    _V2_CALIBRATION,
+    PHASE_MARKER_ID,
+    STATS_MAGIC,
+    THROUGHPUT_MARKER_ID,
+    StatsFormatError,
+    StatsHeader,
+    _parse_meta,
+)
+
+
+def _header_from_buffer(buf: memoryview, path: str) -> tuple[StatsHeader, int]:
+    """Parse a statistics header from a mapped file.
+
+    Returns:
+        (header, data_offset) where data_offset is the position of the
+        first record.
+
+    Raises:
+        StatsFormatError: If the buffer is not a statistics file.
+    """
+    if len(buf) < _HEADER.size:
+        raise StatsFormatError(f"{path}: truncated header")
+    magic, version, start_ts_ns = _HEADER.unpack_from(buf, 0)
+    if magic != STATS_MAGIC:
+        raise StatsFormatError(f"{path}: bad magic {magic!r} (not a stats file)")
+
+    if version < 2:
+        return StatsHeader(version=version, start_ts_ns=start_ts_ns), _HEADER.size
+
+    if len(buf) < _HEADER.size + _V2_CALIBRATION.size:
+        raise StatsFormatError(f"{path}: truncated calibration block")
+    clock_overhead_ns, bump_overhead_ns, min_delay_ns, meta_len = (
+        _V2_CALIBRATION.unpack_from(buf, _HEADER.size)
+    )
+    meta_start = _HEADER.size + _V2_CALIBRATION.size
+    if len(buf) < meta_start + meta_len:
+        raise StatsFormatError(f"{path}: truncated metadata block")
+    meta = _parse_meta(bytes(buf[meta_start : meta_start + meta_len]), path)
+
+    header = StatsHeader(
+        version=version,
+        start_ts_ns=start_ts_ns,
+        clock_overhead_ns=clock_overhead_ns,
+        bump_overhead_ns=bump_overhead_ns,
+        min_delay_ns=min_delay_ns,
+        meta=meta,
+    )
+    return header, meta_start + meta_len
+
+
+def _iter_records(buf: memoryview, offset: int):
+    """Iterate (code_id, ts_ns, delay_ns) tuples from a mapped file.
+
+    A trailing partial record (a run that was killed mid-flush) is
+    ignored rather than treated as corruption.
+    """
+    end = offset + ((len(buf) - offset) // _RECORD.size) * _RECORD.size
+    return _RECORD.iter_unpack(buf[offset:end])
+
+
+def _format_ns(ns: int | float) -> str:
+    """Render a nanosecond quantity with a readable unit."""
+    if ns >= 1_000_000_000:
+        return f"{ns / 1e9:.3f}s"
+    if ns >= 1_000_000:
+        return f"{ns / 1e6:.3f}ms"
+    if ns >= 1_000:
+        return f"{ns / 1e3:.1f}us"
+    return f"{int(ns)}ns"
+
+
+def render_report(path: str, top: int = 20, out=sys.stdout) -> None:
+    """Write a human-readable report for one statistics file.
+
+    Args:
+        path: Statistics file to analyse.
+        top: Number of code objects to list in the hit table.
+        out: Stream to write the report to.
+
+    Raises:
+        StatsFormatError: If the file is not a statistics file.
+        OSError: If the file cannot be opened or mapped.
+    """
+    with open(path, "rb") as f:
+        size = os.fstat(f.fileno()).st_size
+        if size == 0:
+            raise StatsFormatError(f"{path}: truncated header")
+        with mmap.mmap(f.fileno(), 0, prot=mmap.PROT_READ) as mm:
+            buf = memoryview(mm)
+            try:
+                header, offset = _header_from_buffer(buf, path)
+
+                # Pass 1: phase boundaries (a handful of records at most)
+                phase_starts: list[int] = []  # boundary timestamps
+                phase_delays: list[int] = []  # the entered phase's delay
+                for code_id, ts_ns, delay_ns in _iter_records(buf, offset):
+                    if code_id == PHASE_MARKER_ID:
+                        phase_starts.append(ts_ns)
+                        phase_delays.append(delay_ns)
+
+                # Pass 2: aggregate per code object and per phase. Index
+                # 0 is everything before the first boundary (warmup, or
+                # the whole run when there is no sweep).
+                hits: Counter[int] = Counter()
+                delay_totals: Counter[int] = Counter()
+                phase_bumps = [0] * (len(phase_starts) + 1)
+                phase_delay_ns = [0] * (len(phase_starts) + 1)
+                phase_units = [0] * (len(phase_starts) + 1)
+                phase_last_ts = [0] * (len(phase_starts) + 1)
+                for code_id, ts_ns, delay_ns in _iter_records(buf, offset):
+                    if code_id == PHASE_MARKER_ID:
+                        continue
+                    phase = bisect.bisect_right(phase_starts, ts_ns)
+                    phase_last_ts[phase] = max(phase_last_ts[phase], ts_ns)
+                    if code_id == THROUGHPUT_MARKER_ID:
+                        phase_units[phase] += delay_ns
+                        continue
+                    hits[code_id] += 1
+                    delay_totals[code_id] += delay_ns
+                    phase_bumps[phase] += 1
+                    phase_delay_ns[phase] += delay_ns
+            finally:
+                buf.release()
+
+    print(f"{path}: format v{header.version}", file=out)
+    if header.version >= 2:
+        print(
+            f"  calibration: clock overhead {header.clock_overhead_ns}ns, "
+            f"bump overhead {header.bump_overhead_ns}ns, "
+            f"min delay {header.min_delay_ns}ns",
+            file=out,
+        )
+        for key, value in header.meta:
+            print(f"  {key} {value}", file=out)
+
+    total_bumps = sum(hits.values())
+    total_delay = sum(delay_totals.values())
+    print(
+        f"\n{total_bumps} bumps, {_format_ns(total_delay)} total injected delay",
+        file=out,
+    )
+    if hits:
+        print(f"\n{'code_id':>18} {'hits':>10} {'total_delay':>12} {'mean':>10}", file=out)
+        ranked = sorted(delay_totals, key=delay_totals.__getitem__, reverse=True)
+        for code_id in ranked[:top]:
+            count = hits[code_id]
+            total = delay_totals[code_id]
+            print(
+                f"{code_id:>#18x} {count:>10} {_format_ns(total):>12} "
+                f"{_format_ns(total / count):>10}",
+                file=out,
+            )
+        if len(ranked) > top:
+            print(f"  ... and {len(ranked) - top} more code objects", file=out)
+
+    if phase_starts:
+        print(
+            f"\n{'phase_delay':>12} {'duration':>10} {'bumps':>10} "
+            f"{'injected':>10} {'units':>10} {'units/s':>10}",
+            file=out,
+        )
+        boundaries = [header.start_ts_ns] + phase_starts
+        delays = [None] + phase_delays
+        for phase in range(len(boundaries)):
+            if phase + 1 < len(boundaries):
+                span_ns = boundaries[phase + 1] - boundaries[phase]
+            else:
+                span_ns = max(phase_last_ts[phase] - boundaries[phase], 0)
+            if phase == 0 and phase_bumps[0] == 0 and phase_units[0] == 0:
+                continue  # nothing happened before the sweep started
+            label = "(pre)" if delays[phase] is None else _format_ns(delays[phase])
+            units = phase_units[phase]
+            rate = f"{units / (span_ns / 1e9):.1f}" if span_ns > 0 and units else "-"
+            print(
+                f"{label:>12} {_format_ns(span_ns):>10} {phase_bumps[phase]:>10} "
+                f"{_format_ns(phase_delay_ns[phase]):>10} {units:>10} {rate:>10}",
+                file=out,
+            )
+    elif any(phase_units):
+        units = phase_units[0]
+        span_ns = max(phase_last_ts[0] - header.start_ts_ns, 0)
+        rate = f"{units / (span_ns / 1e9):.1f}" if span_ns > 0 else "-"
+        print(f"\n{units} units marked, {rate} units/s", file=out)
+
+
+def main(argv: list[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(
+        prog="speed-bump-report",
+        description="Summarise speed-bump statistics files.",
+    )
+    parser.add_argument(
+        "paths",
+        nargs="+",
+        metavar="STATS_FILE",
+        help="Statistics file(s) written via SPEED_BUMP_STATS or stats_start",
+    )
+    parser.add_argument(
+        "--top",
+        "-t",
+        type=int,
+        default=20,
+        help="Number of code objects to list (default: 20)",
+    )
+    args = parser.parse_args(argv)
+
+    status = 0
+    for index, path in enumerate(args.paths):
+        if index > 0:
+            print()
+        try:
+            render_report(path, top=args.top)
+        except (StatsFormatError, OSError) as e:
+            print(f"speed-bump-report: {e}", file=sys.stderr)
+            status = 1
+    return status
+
+
+if __name__ == "__main__":
+    sys.exit(main())
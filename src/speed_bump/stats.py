@@ -0,0 +1,322 @@
+"""Reading statistics files produced by speed-bump.
+
+Statistics collection (enabled via SPEED_BUMP_STATS or
+speed_bump.stats_start) writes a compact binary file: a header carrying
+the calibration constants and the resolved configuration, followed by
+fixed-width records, one per applied bump or throughput marker
+(speed_bump.mark). Version 1 files (bare 16-byte header) still read.
+
+Example:
+    >>> from speed_bump import stats
+    >>> for record in stats.read_records("bumps.bin"):
+    ...     print(record.code_id, record.delay_ns)
+"""
+
+from __future__ import annotations
+
+import os
+import struct
+from collections import Counter
+from collections.abc import Iterator
+from dataclasses import dataclass
+
+STATS_MAGIC = b"SBST"
+
+# code_id of phase marker records. When a delay sweep is active, a
+# record with this id is written at each phase boundary; its delay_ns is
+# the entered phase's delay. No real code object has id 0.
+PHASE_MARKER_ID = 0
+
+# code_id of throughput marker records written by speed_bump.mark();
+# their delay_ns field carries the unit count. Small integers are never
+# real code-object ids, which are heap addresses.
+THROUGHPUT_MARKER_ID = 1
+
+_HEADER = struct.Struct("<4sIQ")
+_V2_CALIBRATION = struct.Struct("<QQQI")  # overheads, min delay, meta length
+_RECORD = struct.Struct("<QQQ")
+
+
+class StatsFormatError(Exception):
+    """Error in a statistics file's format."""
+
+
+@dataclass(frozen=True, slots=True)
+class StatsHeader:
+    """Header of a statistics file."""
+
+    version: int
+    """Format version."""
+
+    start_ts_ns: int
+    """CLOCK_MONOTONIC timestamp when recording started."""
+
+    clock_overhead_ns: int = 0
+    """Calibrated per-read overhead of the spin loop's timer on the
+    recording host (version 2+; 0 in version 1 files)."""
+
+    bump_overhead_ns: int = 0
+    """Fixed per-bump overhead that was subtracted from each requested
+    delay (version 2+; 0 in version 1 files)."""
+
+    min_delay_ns: int = 0
+    """Minimum achievable delay on the recording host (version 2+; 0 in
+    version 1 files)."""
+
+    meta: tuple[tuple[str, str], ...] = ()
+    """The resolved configuration as (key, value) pairs, e.g. one
+    ("target", pattern) entry per target. Keys repeat, so this is not a
+    mapping. Empty in version 1 files or when no metadata was given."""
+
+
+@dataclass(frozen=True, slots=True)
+class BumpRecord:
+    """One recorded bump."""
+
+    code_id: int
+    """id() of the bumped code object."""
+
+    ts_ns: int
+    """CLOCK_MONOTONIC timestamp of the bump."""
+
+    delay_ns: int
+    """Delay that was applied, in nanoseconds."""
+
+
+@dataclass(frozen=True, slots=True)
+class MarkRecord:
+    """One throughput marker recorded via speed_bump.mark()."""
+
+    ts_ns: int
+    """CLOCK_MONOTONIC timestamp of the mark."""
+
+    units: int
+    """Number of work units the caller reported as completed."""
+
+
+def _parse_meta(data: bytes, path: str | os.PathLike[str]) -> tuple[tuple[str, str], ...]:
+    """Parse a metadata block's "key value" lines into (key, value) pairs."""
+    try:
+        text = data.decode("utf-8")
+    except UnicodeDecodeError:
+        raise StatsFormatError(f"{path}: metadata block is not UTF-8") from None
+    pairs = []
+    for line in text.splitlines():
+        key, _, value = line.partition(" ")
+        if key:
+            pairs.append((key, value))
+    return tuple(pairs)
+
+
+def _read_header(f, path: str | os.PathLike[str]) -> tuple[StatsHeader, int]:
+    """Read the header from an open stream.
+
+    Returns:
+        (header, data_offset) where data_offset is the file position of
+        the first record.
+
+    Raises:
+        StatsFormatError: If the stream is not a speed-bump statistics
+            file.
+    """
+    data = f.read(_HEADER.size)
+    if len(data) < _HEADER.size:
+        raise StatsFormatError(f"{path}: truncated header")
+
+    magic, version, start_ts_ns = _HEADER.unpack(data)
+    if magic != STATS_MAGIC:
+        raise StatsFormatError(f"{path}: bad magic {magic!r} (not a stats file)")
+
+    if version < 2:
+        return StatsHeader(version=version, start_ts_ns=start_ts_ns), _HEADER.size
+
+    data = f.read(_V2_CALIBRATION.size)
+    if len(data) < _V2_CALIBRATION.size:
+        raise StatsFormatError(f"{path}: truncated calibration block")
+    clock_overhead_ns, bump_overhead_ns, min_delay_ns, meta_len = (
+        _V2_CALIBRATION.unpack(data)
+    )
+
+    meta_data = f.read(meta_len)
+    if len(meta_data) < meta_len:
+        raise StatsFormatError(f"{path}: truncated metadata block")
+
+    header = StatsHeader(
+        version=version,
+        start_ts_ns=start_ts_ns,
+        clock_overhead_ns=clock_overhead_ns,
+        bump_overhead_ns=bump_overhead_ns,
+        min_delay_ns=min_delay_ns,
+        meta=_parse_meta(meta_data, path),
+    )
+    return header, _HEADER.size + _V2_CALIBRATION.size + meta_len
+
+
+def read_header(path: str | os.PathLike[str]) -> StatsHeader:
+    """Read and validate the header of a statistics file.
+
+    Raises:
+        StatsFormatError: If the file is not a speed-bump statistics file.
+    """
+    with open(path, "rb") as f:
+        header, _ = _read_header(f, path)
+    return header
+
+
+def read_records(path: str | os.PathLike[str]) -> Iterator[BumpRecord]:
+    """Iterate over the records in a statistics file.
+
+    Yields:
+        BumpRecord objects in file (flush) order.
+
+    Raises:
+        StatsFormatError: If the file is not a speed-bump statistics file.
+    """
+    with open(path, "rb") as f:
+        _read_header(f, path)
+        while True:
+            data = f.read(_RECORD.size)
+            if len(data) < _RECORD.size:
+                break
+            code_id, ts_ns, delay_ns = _RECORD.unpack(data)
+            yield BumpRecord(code_id=code_id, ts_ns=ts_ns, delay_ns=delay_ns)
+
+
+def hit_counts(path: str | os.PathLike[str]) -> dict[int, int]:
+    """Per-code-object bump counts for a statistics file.
+
+    Phase and throughput marker records are not counted.
+
+    Returns:
+        Mapping of code-object id to number of bumps applied.
+    """
+    counts: Counter[int] = Counter()
+    for record in read_records(path):
+        if record.code_id not in (PHASE_MARKER_ID, THROUGHPUT_MARKER_ID):
+            counts[record.code_id] += 1
+    return dict(counts)
+
+
+def phase_markers(path: str | os.PathLike[str]) -> list[BumpRecord]:
+    """The phase boundary markers in a statistics file.
+
+    When a delay sweep (SPEED_BUMP_SWEEP) is active, each phase
+    transition writes a marker record whose ts_ns is the boundary time
+    and whose delay_ns is the entered phase's delay. Bump records can be
+    segmented per phase by splitting on the marker timestamps.
+
+    Returns:
+        Marker records in phase order (empty without a sweep).
+    """
+    return [r for r in read_records(path) if r.code_id == PHASE_MARKER_ID]
+
+
+def throughput_marks(path: str | os.PathLike[str]) -> list[MarkRecord]:
+    """The throughput markers in a statistics file.
+
+    speed_bump.mark(units) records (timestamp, unit count) into the
+    same stream as the bump statistics; summing units between two
+    timestamps (e.g. consecutive phase markers) gives the throughput
+    achieved under that phase's delay, so the sensitivity curve falls
+    out of a single file.
+
+    Returns:
+        MarkRecord objects in file (flush) order.
+    """
+    return [
+        MarkRecord(ts_ns=r.ts_ns, units=r.delay_ns)
+        for r in read_records(path)
+        if r.code_id == THROUGHPUT_MARKER_ID
+    ]
+
+
+@dataclass(frozen=True, slots=True)
+class ProcessReport:
+    """Aggregated statistics for one process of a multi-process run."""
+
+    pid: int
+    """Process id, from the stats file name."""
+
+    role: str | None
+    """Role label (SPEED_BUMP_ROLE), or None if the process set none."""
+
+    hit_counts: dict[int, int]
+    """Per-code-object bump counts, as from hit_counts()."""
+
+    total_delay_ns: int
+    """Sum of all delays applied in this process."""
+
+    units: int
+    """Total work units reported via speed_bump.mark()."""
+
+
+def _read_run_role(run_dir: str | os.PathLike[str], pid: int) -> str | None:
+    """Read the role from a run directory's proc.<pid> meta file."""
+    try:
+        text = os.path.join(run_dir, f"proc.{pid}")
+        with open(text, encoding="utf-8") as f:
+            for line in f:
+                key, _, value = line.strip().partition(" ")
+                if key == "role" and value:
+                    return value
+    except OSError:
+        pass
+    return None
+
+
+def aggregate_run(run_dir: str | os.PathLike[str]) -> list[ProcessReport]:
+    """Merge the per-process stats of a SPEED_BUMP_RUN_DIR run.
+
+    Scans <run_dir>/stats.<pid>.bin files and joins each against its
+    proc.<pid> meta file, producing one report entry per process keyed
+    by pid and role. This is the cross-worker view: compare units
+    across roles to see whether bumping one rank's code stalls the
+    others.
+
+    Files still being written (a run in progress) are read up to their
+    current length; files that are not valid stats files are skipped.
+
+    Returns:
+        ProcessReport entries ordered by pid (empty for an empty or
+        missing directory).
+    """
+    reports: list[ProcessReport] = []
+    try:
+        names = os.listdir(run_dir)
+    except OSError:
+        return reports
+
+    for name in sorted(names):
+        parts = name.split(".")
+        if len(parts) != 3 or parts[0] != "stats" or parts[2] != "bin":
+            continue
+        try:
+            pid = int(parts[1])
+        except ValueError:
+            continue
+
+        path = os.path.join(run_dir, name)
+        counts: Counter[int] = Counter()
+        total_delay_ns = 0
+        units = 0
+        try:
+            for record in read_records(path):
+                if record.code_id == THROUGHPUT_MARKER_ID:
+                    units += record.delay_ns
+                elif record.code_id != PHASE_MARKER_ID:
+                    counts[record.code_id] += 1
+                    total_delay_ns += record.delay_ns
+        except (StatsFormatError, OSError):
+            continue
+
+        reports.append(
+            ProcessReport(
+                pid=pid,
+                role=_read_run_role(run_dir, pid),
+                hit_counts=dict(counts),
+                total_delay_ns=total_delay_ns,
+                units=units,
+            )
+        )
+
+    return reports
@@ -2,8 +2,14 @@
 
 from __future__ import annotations
 
+import subprocess
+import sys
+from pathlib import Path
+
 import speed_bump
 
+_SRC_PATH = str(Path(__file__).parent.parent / "src")
+
 
 class TestCalibration:
     """Tests for clock_gettime calibration."""
@@ -28,9 +34,17 @@ class TestCalibration:
         val2 = speed_bump.get_clock_overhead_ns()
         assert val1 == val2
 
-    def test_min_delay_is_double_overhead(self) -> None:
-        """Minimum delay should be 2x the overhead."""
-        assert speed_bump.min_delay_ns == 2 * speed_bump.clock_overhead_ns
+    def test_min_delay_is_double_read_overhead(self) -> None:
+        """Minimum delay should be 2x the active timer's read overhead."""
+        assert speed_bump.min_delay_ns == 2 * speed_bump.get_timer_overhead_ns()
+
+    def test_timer_backend_is_known(self) -> None:
+        """Timer backend must be one of the supported backends."""
+        assert speed_bump.get_timer_backend() in ("tsc", "cntvct", "clock_gettime")
+
+    def test_timer_overhead_not_above_clock_overhead(self) -> None:
+        """The selected backend should never read slower than clock_gettime."""
+        assert speed_bump.get_timer_overhead_ns() <= speed_bump.clock_overhead_ns
 
     def test_is_calibrated(self) -> None:
         """Module should report as calibrated after import."""
@@ -40,3 +54,128 @@ class TestCalibration:
         """Module attributes should match function return values."""
         assert speed_bump.clock_overhead_ns == speed_bump.get_clock_overhead_ns()
         assert speed_bump.min_delay_ns == speed_bump.get_min_delay_ns()
+
+
+class TestBumpOverhead:
+    """Tests for the per-bump overhead compensation figures."""
+
+    def test_dispatch_overhead_measured_at_import(self) -> None:
+        """The delay dispatch's own cost is calibrated at module init."""
+        assert speed_bump.bump_overhead_ns > 0
+
+    def test_bump_overhead_is_plausible(self) -> None:
+        """Total per-bump overhead stays well below the smallest useful delay."""
+        assert speed_bump.get_bump_overhead_ns() <= 11_000
+
+    def test_callback_overhead_measured_at_install(self) -> None:
+        """install() measures the callback cost and folds it into the total."""
+        import time
+
+        from speed_bump._patterns import parse_pattern
+
+        config = speed_bump.Config(
+            enabled=True,
+            targets=(parse_pattern("zzz_nowhere:zzz_nothing", 1),),
+            delay_ns=1000,
+            frequency=1,
+            start_ns=time.time_ns(),
+            end_ns=None,
+        )
+        assert speed_bump.install(config)
+        try:
+            callback_ns = speed_bump.get_callback_overhead_ns()
+            assert callback_ns > 0
+            assert speed_bump.get_bump_overhead_ns() >= callback_ns
+        finally:
+            speed_bump.uninstall()
+            speed_bump.clear_cache()
+
+
+class TestCalibrationCache:
+    """Tests for the persistent per-host calibration cache."""
+
+    @staticmethod
+    def _run(code: str, cache: Path, **extra: str) -> subprocess.CompletedProcess[str]:
+        """Import speed_bump in a subprocess with the cache pointed at a file."""
+        env = {
+            "PYTHONPATH": _SRC_PATH,
+            "SPEED_BUMP_CALIBRATION_CACHE": str(cache),
+            **extra,
+        }
+        return subprocess.run(
+            [sys.executable, "-c", code],
+            capture_output=True,
+            text=True,
+            env=env,
+        )
+
+    def test_first_import_writes_cache(self, tmp_path: Path) -> None:
+        """A fresh host measures calibration and persists it."""
+        cache = tmp_path / "calibration"
+        result = self._run("import speed_bump", cache)
+        assert result.returncode == 0, result.stderr
+        text = cache.read_text()
+        assert text.startswith("version 1\n")
+        assert "key " in text
+        assert "clock_overhead_ns " in text
+
+    def test_second_import_loads_cache(self, tmp_path: Path) -> None:
+        """A warm cache is loaded instead of re-measuring."""
+        cache = tmp_path / "calibration"
+        assert self._run("import speed_bump", cache).returncode == 0
+        result = self._run(
+            "import speed_bump; assert speed_bump.is_calibrated()",
+            cache,
+            SPEED_BUMP_VERBOSE="1",
+        )
+        assert result.returncode == 0, result.stderr
+        assert "loaded from per-host cache" in result.stderr
+
+    def test_stale_key_falls_back_to_measurement(self, tmp_path: Path) -> None:
+        """A cache written on another host/kernel is ignored and rewritten."""
+        cache = tmp_path / "calibration"
+        assert self._run("import speed_bump", cache).returncode == 0
+        lines = cache.read_text().splitlines(keepends=True)
+        cache.write_text(
+            "".join(
+                "key other-host|cpu|tsc\n" if line.startswith("key ") else line
+                for line in lines
+            )
+        )
+        result = self._run(
+            "import speed_bump; assert speed_bump.is_calibrated()",
+            cache,
+            SPEED_BUMP_VERBOSE="1",
+        )
+        assert result.returncode == 0, result.stderr
+        assert "measured" in result.stderr
+        assert "other-host" not in cache.read_text()
+
+    def test_quiet_without_verbose(self, tmp_path: Path) -> None:
+        """Calibration chatter only appears under SPEED_BUMP_VERBOSE."""
+        cache = tmp_path / "calibration"
+        result = self._run("import speed_bump", cache)
+        assert result.returncode == 0, result.stderr
+        assert "speed_bump:" not in result.stderr
+
+    def test_off_disables_cache(self, tmp_path: Path) -> None:
+        """SPEED_BUMP_CALIBRATION_CACHE=off skips both load and save."""
+        result = self._run(
+            "import speed_bump; assert speed_bump.is_calibrated()",
+            Path("off"),
+        )
+        assert result.returncode == 0, result.stderr
+
+    def test_recalibrate_refreshes_attributes(self, tmp_path: Path) -> None:
+        """recalibrate() re-measures, rewrites the cache and updates attrs."""
+        cache = tmp_path / "calibration"
+        code = (
+            "import speed_bump\n"
+            "speed_bump.recalibrate()\n"
+            "assert speed_bump.is_calibrated()\n"
+            "assert speed_bump.clock_overhead_ns > 0\n"
+            "assert speed_bump.min_delay_ns > 0\n"
+        )
+        result = self._run(code, cache)
+        assert result.returncode == 0, result.stderr
+        assert cache.exists()
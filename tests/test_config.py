@@ -115,6 +115,270 @@ class TestConfigParsing:
         assert "SPEED_BUMP_FREQUENCY" in str(exc_info.value)
         assert "below minimum" in str(exc_info.value)
 
+    def test_delay_mode_defaults_to_spin(self, sample_targets: Path) -> None:
+        """Delay mode defaults to 'spin' when not specified."""
+        env = {"SPEED_BUMP_TARGETS": str(sample_targets)}
+        with mock.patch.dict(os.environ, env, clear=True):
+            config = load_config()
+        assert config.delay_mode == "spin"
+
+    def test_delay_mode_hybrid(self, sample_targets: Path) -> None:
+        """SPEED_BUMP_DELAY_MODE=hybrid is accepted."""
+        env = {
+            "SPEED_BUMP_TARGETS": str(sample_targets),
+            "SPEED_BUMP_DELAY_MODE": "hybrid",
+        }
+        with mock.patch.dict(os.environ, env, clear=True):
+            config = load_config()
+        assert config.delay_mode == "hybrid"
+
+    def test_invalid_delay_mode_raises(self, sample_targets: Path) -> None:
+        """Unknown SPEED_BUMP_DELAY_MODE raises ConfigError."""
+        env = {
+            "SPEED_BUMP_TARGETS": str(sample_targets),
+            "SPEED_BUMP_DELAY_MODE": "busywait",
+        }
+        with mock.patch.dict(os.environ, env, clear=True):
+            with pytest.raises(ConfigError) as exc_info:
+                load_config()
+        assert "SPEED_BUMP_DELAY_MODE" in str(exc_info.value)
+
+    def test_delay_dist_defaults_to_fixed(self, sample_targets: Path) -> None:
+        """Delay distribution defaults to 'fixed' when not specified."""
+        env = {"SPEED_BUMP_TARGETS": str(sample_targets)}
+        with mock.patch.dict(os.environ, env, clear=True):
+            config = load_config()
+        assert config.delay_dist == "fixed"
+
+    def test_delay_dist_pareto(self, sample_targets: Path) -> None:
+        """SPEED_BUMP_DELAY_DIST=pareto is accepted."""
+        env = {
+            "SPEED_BUMP_TARGETS": str(sample_targets),
+            "SPEED_BUMP_DELAY_DIST": "pareto",
+        }
+        with mock.patch.dict(os.environ, env, clear=True):
+            config = load_config()
+        assert config.delay_dist == "pareto"
+
+    def test_invalid_delay_dist_raises(self, sample_targets: Path) -> None:
+        """Unknown SPEED_BUMP_DELAY_DIST raises ConfigError."""
+        env = {
+            "SPEED_BUMP_TARGETS": str(sample_targets),
+            "SPEED_BUMP_DELAY_DIST": "weibull",
+        }
+        with mock.patch.dict(os.environ, env, clear=True):
+            with pytest.raises(ConfigError) as exc_info:
+                load_config()
+        assert "SPEED_BUMP_DELAY_DIST" in str(exc_info.value)
+
+    def test_sweep_defaults_to_disabled(self, sample_targets: Path) -> None:
+        """No SPEED_BUMP_SWEEP means an empty sweep schedule."""
+        env = {"SPEED_BUMP_TARGETS": str(sample_targets)}
+        with mock.patch.dict(os.environ, env, clear=True):
+            config = load_config()
+        assert config.sweep == ()
+
+    def test_sweep_parses_phases(self, sample_targets: Path) -> None:
+        """SPEED_BUMP_SWEEP phases parse into (delay_ns, duration_ns)."""
+        env = {
+            "SPEED_BUMP_TARGETS": str(sample_targets),
+            "SPEED_BUMP_SWEEP": "0:60000, 1000:60000, 10000:30000",
+        }
+        with mock.patch.dict(os.environ, env, clear=True):
+            config = load_config()
+        assert config.sweep == (
+            (0, 60_000_000_000),
+            (1000, 60_000_000_000),
+            (10000, 30_000_000_000),
+        )
+
+    def test_invalid_sweep_raises(self, sample_targets: Path) -> None:
+        """Malformed SPEED_BUMP_SWEEP raises ConfigError."""
+        for bad in ["1000", "1000:abc", "1000:0", "-1:60000"]:
+            env = {
+                "SPEED_BUMP_TARGETS": str(sample_targets),
+                "SPEED_BUMP_SWEEP": bad,
+            }
+            with mock.patch.dict(os.environ, env, clear=True):
+                with pytest.raises(ConfigError) as exc_info:
+                    load_config()
+            assert "SPEED_BUMP_SWEEP" in str(exc_info.value)
+
+    def test_threads_defaults_to_all(self, sample_targets: Path) -> None:
+        """No SPEED_BUMP_THREADS means an empty filter (all threads)."""
+        env = {"SPEED_BUMP_TARGETS": str(sample_targets)}
+        with mock.patch.dict(os.environ, env, clear=True):
+            config = load_config()
+        assert config.threads == ()
+
+    def test_threads_parses_globs(self, sample_targets: Path) -> None:
+        """SPEED_BUMP_THREADS splits on commas and strips whitespace."""
+        env = {
+            "SPEED_BUMP_TARGETS": str(sample_targets),
+            "SPEED_BUMP_THREADS": "MainThread, worker-*,",
+        }
+        with mock.patch.dict(os.environ, env, clear=True):
+            config = load_config()
+        assert config.threads == ("MainThread", "worker-*")
+
+    def test_stretch_defaults_to_disabled(self, sample_targets: Path) -> None:
+        """No SPEED_BUMP_STRETCH means stretch mode is off."""
+        env = {"SPEED_BUMP_TARGETS": str(sample_targets)}
+        with mock.patch.dict(os.environ, env, clear=True):
+            config = load_config()
+        assert config.stretch == 0.0
+
+    def test_stretch_parses_factor(self, sample_targets: Path) -> None:
+        """SPEED_BUMP_STRETCH parses as a float multiplier."""
+        env = {
+            "SPEED_BUMP_TARGETS": str(sample_targets),
+            "SPEED_BUMP_STRETCH": "1.5",
+        }
+        with mock.patch.dict(os.environ, env, clear=True):
+            config = load_config()
+        assert config.stretch == 1.5
+
+    def test_invalid_stretch_raises(self, sample_targets: Path) -> None:
+        """Non-numeric or below-1.0 SPEED_BUMP_STRETCH raises ConfigError."""
+        for bad in ["fast", "0.5"]:
+            env = {
+                "SPEED_BUMP_TARGETS": str(sample_targets),
+                "SPEED_BUMP_STRETCH": bad,
+            }
+            with mock.patch.dict(os.environ, env, clear=True):
+                with pytest.raises(ConfigError) as exc_info:
+                    load_config()
+            assert "SPEED_BUMP_STRETCH" in str(exc_info.value)
+
+    def test_coroutines_defaults_to_disabled(self, sample_targets: Path) -> None:
+        """No SPEED_BUMP_COROUTINES means call-only bumping."""
+        env = {"SPEED_BUMP_TARGETS": str(sample_targets)}
+        with mock.patch.dict(os.environ, env, clear=True):
+            config = load_config()
+        assert config.coroutines is False
+
+    def test_coroutines_parses_flag(self, sample_targets: Path) -> None:
+        """SPEED_BUMP_COROUTINES=1 enables per-resume bumping; 0 does not."""
+        for value, expected in [("1", True), ("0", False)]:
+            env = {
+                "SPEED_BUMP_TARGETS": str(sample_targets),
+                "SPEED_BUMP_COROUTINES": value,
+            }
+            with mock.patch.dict(os.environ, env, clear=True):
+                config = load_config()
+            assert config.coroutines is expected
+
+    def test_c_calls_defaults_to_disabled(self, sample_targets: Path) -> None:
+        """No SPEED_BUMP_C_CALLS means interpreted-only bumping."""
+        env = {"SPEED_BUMP_TARGETS": str(sample_targets)}
+        with mock.patch.dict(os.environ, env, clear=True):
+            config = load_config()
+        assert config.c_calls is False
+
+    def test_c_calls_parses_flag(self, sample_targets: Path) -> None:
+        """SPEED_BUMP_C_CALLS=1 enables C-call interception; 0 does not."""
+        for value, expected in [("1", True), ("0", False)]:
+            env = {
+                "SPEED_BUMP_TARGETS": str(sample_targets),
+                "SPEED_BUMP_C_CALLS": value,
+            }
+            with mock.patch.dict(os.environ, env, clear=True):
+                config = load_config()
+            assert config.c_calls is expected
+
+    def test_rate_defaults_to_off(self, sample_targets: Path) -> None:
+        """No SPEED_BUMP_RATE means no bumps-per-second cap."""
+        env = {"SPEED_BUMP_TARGETS": str(sample_targets)}
+        with mock.patch.dict(os.environ, env, clear=True):
+            config = load_config()
+        assert config.rate == 0.0
+
+    def test_rate_parses_float(self, sample_targets: Path) -> None:
+        """SPEED_BUMP_RATE parses as a float cap in bumps per second."""
+        env = {
+            "SPEED_BUMP_TARGETS": str(sample_targets),
+            "SPEED_BUMP_RATE": "200.5",
+        }
+        with mock.patch.dict(os.environ, env, clear=True):
+            config = load_config()
+        assert config.rate == 200.5
+
+    def test_invalid_rate_raises(self, sample_targets: Path) -> None:
+        """A non-numeric or negative SPEED_BUMP_RATE raises ConfigError."""
+        for value in ("fast", "-1"):
+            env = {
+                "SPEED_BUMP_TARGETS": str(sample_targets),
+                "SPEED_BUMP_RATE": value,
+            }
+            with mock.patch.dict(os.environ, env, clear=True):
+                with pytest.raises(ConfigError) as exc_info:
+                    load_config()
+            assert "SPEED_BUMP_RATE" in str(exc_info.value)
+
+    def test_window_defaults_to_none(self, sample_targets: Path) -> None:
+        """No SPEED_BUMP_WINDOW means delays stay armed continuously."""
+        env = {"SPEED_BUMP_TARGETS": str(sample_targets)}
+        with mock.patch.dict(os.environ, env, clear=True):
+            config = load_config()
+        assert config.window is None
+
+    def test_window_parses_duty_cycle(self, sample_targets: Path) -> None:
+        """SPEED_BUMP_WINDOW=on_ms:off_ms parses to nanosecond phases."""
+        env = {
+            "SPEED_BUMP_TARGETS": str(sample_targets),
+            "SPEED_BUMP_WINDOW": "100:900",
+        }
+        with mock.patch.dict(os.environ, env, clear=True):
+            config = load_config()
+        assert config.window == (100_000_000, 900_000_000)
+
+    def test_invalid_window_raises(self, sample_targets: Path) -> None:
+        """A malformed or sub-millisecond SPEED_BUMP_WINDOW raises."""
+        for value in ("100", "on:off", "0:900", "100:-1"):
+            env = {
+                "SPEED_BUMP_TARGETS": str(sample_targets),
+                "SPEED_BUMP_WINDOW": value,
+            }
+            with mock.patch.dict(os.environ, env, clear=True):
+                with pytest.raises(ConfigError) as exc_info:
+                    load_config()
+            assert "SPEED_BUMP_WINDOW" in str(exc_info.value)
+
+    def test_run_dir_derives_per_process_paths(
+        self, sample_targets: Path, tmp_path: Path
+    ) -> None:
+        """A run directory supplies per-pid stats and shared control paths."""
+        run_dir = tmp_path / "run"
+        env = {
+            "SPEED_BUMP_TARGETS": str(sample_targets),
+            "SPEED_BUMP_RUN_DIR": str(run_dir),
+            "SPEED_BUMP_ROLE": "rank0",
+        }
+        with mock.patch.dict(os.environ, env, clear=True):
+            config = load_config()
+
+        pid = os.getpid()
+        assert config.stats_path == str(run_dir / f"stats.{pid}.bin")
+        assert config.control_path == str(run_dir / "control")
+        assert (run_dir / f"proc.{pid}").read_text() == "role rank0\n"
+
+    def test_run_dir_keeps_explicit_paths(
+        self, sample_targets: Path, tmp_path: Path
+    ) -> None:
+        """Explicit SPEED_BUMP_STATS/CONTROL win over run-dir defaults."""
+        run_dir = tmp_path / "run"
+        env = {
+            "SPEED_BUMP_TARGETS": str(sample_targets),
+            "SPEED_BUMP_RUN_DIR": str(run_dir),
+            "SPEED_BUMP_STATS": str(tmp_path / "my.bin"),
+            "SPEED_BUMP_CONTROL": str(tmp_path / "my-control"),
+        }
+        with mock.patch.dict(os.environ, env, clear=True):
+            config = load_config()
+
+        assert config.stats_path == str(tmp_path / "my.bin")
+        assert config.control_path == str(tmp_path / "my-control")
+
     def test_delay_clamped_to_minimum(self, sample_targets: Path) -> None:
         """Delay below minimum is clamped with warning."""
         import speed_bump
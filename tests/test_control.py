@@ -0,0 +1,172 @@
+"""Tests for the live runtime control plane."""
+
+from __future__ import annotations
+
+import time
+from pathlib import Path
+
+import pytest
+
+from speed_bump import Config, clear_cache, install, uninstall
+from speed_bump import _control
+from speed_bump._config import ConfigError
+from speed_bump._control import apply_commands, parse_command_file
+
+
+@pytest.fixture(autouse=True)
+def cleanup_monitoring():
+    """Ensure the watcher and monitoring are torn down after each test."""
+    yield
+    _control.stop()
+    uninstall()
+    clear_cache()
+
+
+def _install_config(targets_file: Path, delay_ns: int = 1_000_000) -> Config:
+    from speed_bump._patterns import load_targets
+
+    targets = load_targets(targets_file)
+    config = Config(
+        enabled=True,
+        targets=tuple(targets),
+        delay_ns=delay_ns,
+        frequency=1,
+        start_ns=time.time_ns() - 1_000_000_000,
+        end_ns=None,
+    )
+    assert install(config) is True
+    return config
+
+
+class TestCommandParsing:
+    """Tests for command file parsing."""
+
+    def test_parses_commands(self, tmp_path: Path) -> None:
+        """Key/value lines parse; comments and blanks are skipped."""
+        control_file = tmp_path / "control"
+        control_file.write_text(
+            """\
+# Retarget the warm server
+targets /some/path.txt
+
+delay_ns 50000
+frequency 10
+"""
+        )
+        commands = parse_command_file(control_file)
+        assert commands == {
+            "targets": "/some/path.txt",
+            "delay_ns": "50000",
+            "frequency": "10",
+        }
+
+    def test_missing_value_raises(self, tmp_path: Path) -> None:
+        """A key without a value raises ConfigError."""
+        control_file = tmp_path / "control"
+        control_file.write_text("delay_ns\n")
+        with pytest.raises(ConfigError) as exc_info:
+            parse_command_file(control_file)
+        assert "missing value" in str(exc_info.value)
+
+    def test_unknown_command_raises(self, tmp_path: Path) -> None:
+        """An unknown key is rejected without touching the config."""
+        targets_file = tmp_path / "targets.txt"
+        targets_file.write_text("*:*control_unknown_test\n")
+        _install_config(targets_file)
+
+        with pytest.raises(ConfigError) as exc_info:
+            apply_commands({"bogus": "1"})
+        assert "unknown command" in str(exc_info.value)
+
+
+class TestApplyCommands:
+    """Tests for applying commands to a live installation."""
+
+    def test_delay_change_applies(self, tmp_path: Path) -> None:
+        """Changing delay_ns takes effect on subsequent calls."""
+        targets_file = tmp_path / "targets.txt"
+        targets_file.write_text("*:*control_delay_test\n")
+        _install_config(targets_file, delay_ns=1_000_000)
+
+        def control_delay_test() -> int:
+            return 42
+
+        start = time.time_ns()
+        for _ in range(20):
+            control_delay_test()
+        before = time.time_ns() - start
+        assert before >= 15_000_000  # ~20ms at 1ms/call
+
+        apply_commands({"delay_ns": "0"})
+
+        start = time.time_ns()
+        for _ in range(20):
+            control_delay_test()
+        after = time.time_ns() - start
+        assert after < 10_000_000, f"delay_ns 0 still delayed: {after}ns"
+
+    def test_retarget_applies(self, tmp_path: Path) -> None:
+        """Swapping the targets file moves the delay to new functions."""
+        old_targets = tmp_path / "old.txt"
+        old_targets.write_text("*:*control_old_target\n")
+        new_targets = tmp_path / "new.txt"
+        new_targets.write_text("*:*control_new_target\n")
+        _install_config(old_targets, delay_ns=1_000_000)
+
+        def control_old_target() -> int:
+            return 42
+
+        def control_new_target() -> int:
+            return 42
+
+        # Classify both under the old config
+        control_old_target()
+        control_new_target()
+
+        apply_commands({"targets": str(new_targets)})
+
+        start = time.time_ns()
+        for _ in range(20):
+            control_new_target()
+        new_elapsed = time.time_ns() - start
+
+        start = time.time_ns()
+        for _ in range(20):
+            control_old_target()
+        old_elapsed = time.time_ns() - start
+
+        assert new_elapsed >= 15_000_000, f"new target not delayed: {new_elapsed}ns"
+        assert old_elapsed < 10_000_000, f"old target still delayed: {old_elapsed}ns"
+
+
+class TestWatcher:
+    """Tests for the control file watcher thread."""
+
+    def test_watcher_applies_file_changes(self, tmp_path: Path) -> None:
+        """Rewriting the control file reconfigures the live install."""
+        targets_file = tmp_path / "targets.txt"
+        targets_file.write_text("*:*control_watch_test\n")
+        _install_config(targets_file, delay_ns=1_000_000)
+
+        control_file = tmp_path / "control"
+        _control.start(str(control_file), poll_interval_s=0.02)
+        assert _control.is_running()
+
+        def control_watch_test() -> int:
+            return 42
+
+        control_file.write_text("delay_ns 0\n")
+
+        # Wait for the watcher to pick the change up
+        deadline = time.time() + 5.0
+        while time.time() < deadline:
+            start = time.time_ns()
+            control_watch_test()
+            if time.time_ns() - start < 500_000:
+                break
+            time.sleep(0.05)
+        else:
+            pytest.fail("watcher never applied delay_ns 0")
+
+        _control.stop()
+        assert not _control.is_running()
@@ -84,3 +84,83 @@ class TestSpinDelay:
         elapsed = time.perf_counter_ns() - start
 
         assert elapsed >= delay_ns, f"Delay of {delay_ns}ns only took {elapsed}ns"
+
+
+class TestHybridDelay:
+    """Tests for the hybrid sleep+spin delay mode."""
+
+    @pytest.fixture(autouse=True)
+    def _restore_spin_mode(self):
+        """Always restore the default spin mode after each test."""
+        yield
+        speed_bump._core.set_delay_mode("spin")
+
+    def test_default_mode_is_spin(self) -> None:
+        """The delay mode defaults to pure spin."""
+        assert speed_bump._core.get_delay_mode() == "spin"
+
+    def test_unknown_mode_raises(self) -> None:
+        """Setting an unknown mode raises ValueError."""
+        with pytest.raises(ValueError, match="unknown delay mode"):
+            speed_bump._core.set_delay_mode("nap")
+
+    def test_hybrid_large_delay_is_accurate(self) -> None:
+        """A 5ms hybrid delay still lands near the requested duration."""
+        speed_bump._core.set_delay_mode("hybrid")
+        delay_ns = 5_000_000
+
+        start = time.perf_counter_ns()
+        speed_bump._core.apply_delay_ns(delay_ns)
+        elapsed = time.perf_counter_ns() - start
+
+        assert elapsed >= delay_ns
+        assert elapsed < delay_ns * 1.2, f"Hybrid delay of {delay_ns}ns took {elapsed}ns"
+
+    def test_hybrid_small_delay_falls_back_to_spin(self) -> None:
+        """Delays below the sleep crossover spin and stay accurate."""
+        speed_bump._core.set_delay_mode("hybrid")
+        delay_ns = 10_000
+
+        start = time.perf_counter_ns()
+        speed_bump._core.apply_delay_ns(delay_ns)
+        elapsed = time.perf_counter_ns() - start
+
+        assert elapsed >= delay_ns
+        assert elapsed < delay_ns * 2
+
+
+class TestDelayDistributions:
+    """Tests for the stochastic delay distributions."""
+
+    @pytest.fixture(autouse=True)
+    def _restore_fixed_dist(self):
+        """Always restore the default fixed distribution after each test."""
+        yield
+        speed_bump.set_delay_dist("fixed")
+
+    def test_default_dist_is_fixed(self) -> None:
+        """The delay distribution defaults to fixed."""
+        assert speed_bump.get_delay_dist() == "fixed"
+
+    def test_unknown_dist_raises(self) -> None:
+        """Setting an unknown distribution raises ValueError."""
+        with pytest.raises(ValueError, match="unknown delay distribution"):
+            speed_bump.set_delay_dist("weibull")
+
+    def test_fixed_returns_requested_delay(self) -> None:
+        """Fixed distribution applies and reports the exact request."""
+        assert speed_bump._core.apply_delay_ns(5_000) == 5_000
+
+    @pytest.mark.parametrize("dist", ["normal", "exponential", "pareto"])
+    def test_sampled_mean_near_requested(self, dist: str) -> None:
+        """Sampled delays average out near the requested mean."""
+        speed_bump.set_delay_dist(dist)
+        mean_ns = 10_000
+        n = 1_000
+
+        samples = [speed_bump._core.apply_delay_ns(mean_ns) for _ in range(n)]
+
+        mean = sum(samples) / n
+        assert 0.8 * mean_ns < mean < 1.3 * mean_ns, f"{dist} mean was {mean}"
+        # Stochastic distributions must actually vary
+        assert len(set(samples)) > 1
@@ -209,6 +209,45 @@ class TestFrequency:
         assert 500_000 <= elapsed <= 5_000_000
 
 
+class TestRateCap:
+    """Tests for the rate (bumps per second) cap."""
+
+    def test_rate_caps_bumps_per_second(self, tmp_path: Path) -> None:
+        """A rate cap bounds total injected delay however hot the loop."""
+        from speed_bump._patterns import load_targets
+
+        targets_file = tmp_path / "targets.txt"
+        targets_file.write_text("*:*rate_test_function delay_ns=1000000 rate=50\n")
+
+        targets = load_targets(targets_file)
+        now = time.time_ns()
+        config = Config(
+            enabled=True,
+            targets=tuple(targets),
+            delay_ns=0,
+            frequency=1,
+            start_ns=now - 1_000_000_000,
+            end_ns=None,
+        )
+        install(config)
+
+        def rate_test_function() -> int:
+            return 42
+
+        # A tight ~300ms loop makes far more calls than the cap allows.
+        # The burst grants up to one second of tokens (50), then refill
+        # adds ~15 more, so injected delay stays near 65ms; every call
+        # bumping at 1ms each would push well past the deadline.
+        calls = 0
+        deadline = time.monotonic() + 0.3
+        while time.monotonic() < deadline:
+            rate_test_function()
+            calls += 1
+
+        # The loop must have run far faster than one bump per call
+        assert calls > 500
+
+
 class TestTimingWindow:
     """Tests for timing window behavior."""
 
@@ -272,6 +311,678 @@ class TestTimingWindow:
         # Should be fast - no delays since window has ended
         assert elapsed < 10_000_000  # Less than 10ms
 
+    def test_duty_cycle_off_phase_no_delay(self, tmp_path: Path) -> None:
+        """During the off phase of a duty cycle, no delay is applied."""
+        from speed_bump._patterns import load_targets
+
+        targets_file = tmp_path / "targets.txt"
+        targets_file.write_text("*:*duty_off_test\n")
+
+        targets = load_targets(targets_file)
+        now = time.time_ns()
+        # Started 200ms ago with a 100ms-on/10s-off cycle: the on phase
+        # is over and the off phase lasts far beyond this test.
+        config = Config(
+            enabled=True,
+            targets=tuple(targets),
+            delay_ns=1_000_000,  # 1ms
+            frequency=1,
+            start_ns=now - 200_000_000,
+            end_ns=None,
+            window=(100_000_000, 10_000_000_000),
+        )
+        install(config)
+
+        def duty_off_test() -> int:
+            return 42
+
+        start = time.time_ns()
+        for _ in range(100):
+            duty_off_test()
+        elapsed = time.time_ns() - start
+
+        # Should be fast - the cycle is in its off phase
+        assert elapsed < 10_000_000  # Less than 10ms
+
+    def test_duty_cycle_on_phase_delays(self, tmp_path: Path) -> None:
+        """During the on phase of a duty cycle, delays are applied."""
+        from speed_bump._patterns import load_targets
+
+        targets_file = tmp_path / "targets.txt"
+        targets_file.write_text("*:*duty_on_test\n")
+
+        targets = load_targets(targets_file)
+        now = time.time_ns()
+        # Started 1s into a 10s-on/100ms-off cycle: the on phase covers
+        # the whole test.
+        config = Config(
+            enabled=True,
+            targets=tuple(targets),
+            delay_ns=1_000_000,  # 1ms
+            frequency=1,
+            start_ns=now - 1_000_000_000,
+            end_ns=None,
+            window=(10_000_000_000, 100_000_000),
+        )
+        install(config)
+
+        def duty_on_test() -> int:
+            return 42
+
+        start = time.time_ns()
+        for _ in range(20):
+            duty_on_test()
+        elapsed = time.time_ns() - start
+
+        # 20 calls at 1ms each: at least ~20ms of injected delay
+        assert elapsed > 15_000_000, f"On phase took only {elapsed}ns"
+
+
+class TestSweep:
+    """Tests for the delay sweep scheduler."""
+
+    def test_sweep_phases_change_delay(self, tmp_path: Path) -> None:
+        """The active sweep phase's delay replaces the default."""
+        from speed_bump._patterns import load_targets
+
+        targets_file = tmp_path / "targets.txt"
+        targets_file.write_text("*:*sweep_phase_test\n")
+
+        targets = load_targets(targets_file)
+        now = time.time_ns()
+        config = Config(
+            enabled=True,
+            targets=tuple(targets),
+            delay_ns=50_000_000,  # 50ms default: must never be applied
+            frequency=1,
+            start_ns=now,
+            end_ns=None,
+            sweep=((0, 200_000_000), (2_000_000, 200_000_000)),
+        )
+        install(config)
+
+        def sweep_phase_test() -> int:
+            return 42
+
+        # Phase 0: zero delay
+        start = time.time_ns()
+        for _ in range(20):
+            sweep_phase_test()
+        elapsed = time.time_ns() - start
+        assert elapsed < 20_000_000, f"Phase 0 (0ns) took {elapsed}ns"
+
+        # Phase 1: 2ms per call
+        time.sleep(0.2)
+        start = time.time_ns()
+        for _ in range(10):
+            sweep_phase_test()
+        elapsed = time.time_ns() - start
+        assert elapsed >= 20_000_000, f"Phase 1 (2ms) took only {elapsed}ns"
+
+    def test_exhausted_sweep_stops_delaying(self, tmp_path: Path) -> None:
+        """After the last phase, no delays are applied."""
+        from speed_bump._patterns import load_targets
+
+        targets_file = tmp_path / "targets.txt"
+        targets_file.write_text("*:*sweep_done_test\n")
+
+        targets = load_targets(targets_file)
+        now = time.time_ns()
+        config = Config(
+            enabled=True,
+            targets=tuple(targets),
+            delay_ns=50_000_000,  # 50ms default: must never be applied
+            frequency=1,
+            start_ns=now - 2_000_000_000,
+            end_ns=None,
+            sweep=((10_000_000, 1_000_000_000),),  # ended 1s ago
+        )
+        install(config)
+
+        def sweep_done_test() -> int:
+            return 42
+
+        start = time.time_ns()
+        for _ in range(50):
+            sweep_done_test()
+        elapsed = time.time_ns() - start
+        assert elapsed < 10_000_000, f"Exhausted sweep still delayed: {elapsed}ns"
+
+
+class TestReconfigure:
+    """Tests for live reconfiguration."""
+
+    def test_reconfigure_not_installed_raises(self, sample_targets: Path) -> None:
+        """reconfigure() without an install raises RuntimeError."""
+        from speed_bump import reconfigure
+        from speed_bump._patterns import load_targets
+
+        targets = load_targets(sample_targets)
+        config = Config(
+            enabled=True,
+            targets=tuple(targets),
+            delay_ns=1000,
+            frequency=1,
+            start_ns=0,
+            end_ns=None,
+        )
+        with pytest.raises(RuntimeError):
+            reconfigure(config)
+
+    def test_reconfigure_swaps_delay(self, tmp_path: Path) -> None:
+        """reconfigure() changes the delay without a reinstall."""
+        import dataclasses
+
+        from speed_bump import reconfigure
+        from speed_bump._patterns import load_targets
+
+        targets_file = tmp_path / "targets.txt"
+        targets_file.write_text("*:*reconfigure_delay_test\n")
+
+        targets = load_targets(targets_file)
+        now = time.time_ns()
+        config = Config(
+            enabled=True,
+            targets=tuple(targets),
+            delay_ns=1_000_000,  # 1ms
+            frequency=1,
+            start_ns=now - 1_000_000_000,
+            end_ns=None,
+        )
+        install(config)
+
+        def reconfigure_delay_test() -> int:
+            return 42
+
+        start = time.time_ns()
+        for _ in range(20):
+            reconfigure_delay_test()
+        before = time.time_ns() - start
+        assert before >= 15_000_000
+
+        reconfigure(dataclasses.replace(config, delay_ns=0))
+
+        start = time.time_ns()
+        for _ in range(20):
+            reconfigure_delay_test()
+        after = time.time_ns() - start
+        assert after < 10_000_000, f"Reconfigured delay still applied: {after}ns"
+
+
+class TestThreadFilter:
+    """Tests for thread-scoped targeting (SPEED_BUMP_THREADS)."""
+
+    def test_non_matching_thread_not_delayed(self, tmp_path: Path) -> None:
+        """A thread outside the filter pays no delay."""
+        from speed_bump._patterns import load_targets
+
+        targets_file = tmp_path / "targets.txt"
+        targets_file.write_text("*:*thread_filter_miss_test\n")
+
+        targets = load_targets(targets_file)
+        now = time.time_ns()
+        config = Config(
+            enabled=True,
+            targets=tuple(targets),
+            delay_ns=1_000_000,  # 1ms
+            frequency=1,
+            start_ns=now - 1_000_000_000,
+            end_ns=None,
+            threads=("no-such-thread-*",),
+        )
+        install(config)
+
+        def thread_filter_miss_test() -> int:
+            return 42
+
+        start = time.time_ns()
+        for _ in range(50):
+            thread_filter_miss_test()
+        elapsed = time.time_ns() - start
+
+        # Should be fast - this thread is not in the filter
+        assert elapsed < 10_000_000, f"Filtered thread was delayed: {elapsed}ns"
+
+    def test_matching_thread_delayed(self, tmp_path: Path) -> None:
+        """A thread whose name matches the filter is delayed normally."""
+        import threading
+
+        from speed_bump._patterns import load_targets
+
+        targets_file = tmp_path / "targets.txt"
+        targets_file.write_text("*:*thread_filter_hit_test\n")
+
+        targets = load_targets(targets_file)
+        now = time.time_ns()
+        config = Config(
+            enabled=True,
+            targets=tuple(targets),
+            delay_ns=1_000_000,  # 1ms
+            frequency=1,
+            start_ns=now - 1_000_000_000,
+            end_ns=None,
+            threads=(threading.current_thread().name,),
+        )
+        install(config)
+
+        def thread_filter_hit_test() -> int:
+            return 42
+
+        start = time.time_ns()
+        for _ in range(20):
+            thread_filter_hit_test()
+        elapsed = time.time_ns() - start
+
+        # 20 calls x 1ms = 20ms expected
+        assert elapsed >= 15_000_000, f"Expected ~20ms of delay, got {elapsed}ns"
+
+
+class TestCallerPatterns:
+    """Tests for caller-qualified (call-path) targeting."""
+
+    def test_only_matching_call_edge_delayed(self, tmp_path: Path) -> None:
+        """A shared function is delayed only when reached from the caller
+        named in the pattern."""
+        from speed_bump._patterns import load_targets
+
+        targets_file = tmp_path / "targets.txt"
+        targets_file.write_text("*:*caller_edge_shared<-*caller_edge_hit\n")
+
+        targets = load_targets(targets_file)
+        now = time.time_ns()
+        config = Config(
+            enabled=True,
+            targets=tuple(targets),
+            delay_ns=1_000_000,  # 1ms
+            frequency=1,
+            start_ns=now - 1_000_000_000,
+            end_ns=None,
+        )
+        install(config)
+
+        def caller_edge_shared() -> int:
+            return 42
+
+        def caller_edge_hit() -> int:
+            start = time.time_ns()
+            for _ in range(20):
+                caller_edge_shared()
+            return time.time_ns() - start
+
+        def caller_edge_miss() -> int:
+            start = time.time_ns()
+            for _ in range(50):
+                caller_edge_shared()
+            return time.time_ns() - start
+
+        # Warm both edges, then measure (edge verdicts are cached)
+        caller_edge_hit()
+        caller_edge_miss()
+
+        hit_elapsed = caller_edge_hit()
+        miss_elapsed = caller_edge_miss()
+
+        # 20 calls x 1ms = 20ms expected on the matching edge
+        assert hit_elapsed >= 15_000_000, f"Expected ~20ms of delay, got {hit_elapsed}ns"
+        assert miss_elapsed < 10_000_000, f"Non-matching edge was delayed: {miss_elapsed}ns"
+
+    def test_edge_order_does_not_stick(self, tmp_path: Path) -> None:
+        """Seeing a non-matching edge first must not disable the code
+        object for later matching edges."""
+        from speed_bump._patterns import load_targets
+
+        targets_file = tmp_path / "targets.txt"
+        targets_file.write_text("*:*edge_order_shared<-*edge_order_second\n")
+
+        targets = load_targets(targets_file)
+        now = time.time_ns()
+        config = Config(
+            enabled=True,
+            targets=tuple(targets),
+            delay_ns=1_000_000,  # 1ms
+            frequency=1,
+            start_ns=now - 1_000_000_000,
+            end_ns=None,
+        )
+        install(config)
+
+        def edge_order_shared() -> int:
+            return 42
+
+        def edge_order_first() -> None:
+            for _ in range(10):
+                edge_order_shared()
+
+        def edge_order_second() -> int:
+            start = time.time_ns()
+            for _ in range(20):
+                edge_order_shared()
+            return time.time_ns() - start
+
+        edge_order_first()  # non-matching edge classified first
+        elapsed = edge_order_second()
+
+        assert elapsed >= 15_000_000, f"Expected ~20ms of delay, got {elapsed}ns"
+
+
+class TestStretch:
+    """Tests for multiplicative stretch mode (delay on return,
+    proportional to each frame's own measured duration)."""
+
+    @staticmethod
+    def _busy_ms(ms: int) -> None:
+        end = time.perf_counter_ns() + ms * 1_000_000
+        while time.perf_counter_ns() < end:
+            pass
+
+    def test_stretch_scales_with_duration(self, tmp_path: Path) -> None:
+        """A stretched function takes roughly stretch x its own time."""
+        from speed_bump._patterns import load_targets
+
+        targets_file = tmp_path / "targets.txt"
+        targets_file.write_text("*:*stretched_target\n")
+
+        targets = load_targets(targets_file)
+        now = time.time_ns()
+        config = Config(
+            enabled=True,
+            targets=tuple(targets),
+            delay_ns=0,
+            frequency=1,
+            start_ns=now - 1_000_000_000,
+            end_ns=None,
+            stretch=2.0,
+        )
+        install(config)
+
+        def stretched_target() -> None:
+            self._busy_ms(2)
+
+        stretched_target()  # classify / warm
+
+        start = time.perf_counter_ns()
+        for _ in range(5):
+            stretched_target()
+        elapsed = time.perf_counter_ns() - start
+
+        # 5 calls of ~2ms body at 2.0x should take ~20ms; the un-stretched
+        # body alone is ~10ms. Allow tolerance for scheduling noise.
+        assert elapsed >= 16_000_000, f"Expected ~20ms stretched, got {elapsed}ns"
+        assert elapsed < 35_000_000, f"Stretch overshot: {elapsed}ns"
+
+    def test_cheap_function_not_punished(self, tmp_path: Path) -> None:
+        """In stretch mode a cheap function pays a proportionally tiny
+        delay, not the fixed delay_ns a per-call bump would inject."""
+        from speed_bump._patterns import load_targets
+
+        targets_file = tmp_path / "targets.txt"
+        targets_file.write_text("*:*cheap_target\n")
+
+        targets = load_targets(targets_file)
+        now = time.time_ns()
+        config = Config(
+            enabled=True,
+            targets=tuple(targets),
+            delay_ns=5_000_000,  # 5ms fixed delay, must NOT be applied
+            frequency=1,
+            start_ns=now - 1_000_000_000,
+            end_ns=None,
+            stretch=2.0,
+        )
+        install(config)
+
+        def cheap_target() -> int:
+            return 42
+
+        cheap_target()  # classify / warm
+
+        start = time.perf_counter_ns()
+        for _ in range(100):
+            cheap_target()
+        elapsed = time.perf_counter_ns() - start
+
+        # 100 calls at the fixed delay would be 500ms; proportional
+        # stretching of a sub-microsecond body should stay well under 10ms
+        assert elapsed < 10_000_000, f"Fixed delay leaked into stretch mode: {elapsed}ns"
+
+
+class TestCoroutines:
+    """Tests for coroutine mode (bump on every resume, per-task counters)."""
+
+    @requires_pep669
+    def test_generator_bumped_per_resume(self, tmp_path: Path) -> None:
+        """With coroutines=True a generator pays one bump per resume."""
+        from speed_bump._patterns import load_targets
+
+        targets_file = tmp_path / "targets.txt"
+        targets_file.write_text("*:*resumed_target\n")
+
+        def resumed_target(n: int):
+            for _ in range(n):
+                yield None
+
+        def drive(n: int) -> int:
+            start = time.perf_counter_ns()
+            for _ in resumed_target(n):
+                pass
+            return time.perf_counter_ns() - start
+
+        targets = load_targets(targets_file)
+        now = time.time_ns()
+        base = dict(
+            enabled=True,
+            targets=tuple(targets),
+            delay_ns=2_000_000,
+            frequency=1,
+            start_ns=now - 1_000_000_000,
+            end_ns=None,
+        )
+
+        # Call-only: one PY_START bump regardless of resume count
+        install(Config(**base))
+        call_only = drive(10)
+        uninstall()
+        clear_cache()
+        assert call_only < 10_000_000, f"Over-bumped without coroutine mode: {call_only}ns"
+
+        # Coroutine mode: PY_START plus one PY_RESUME bump per iteration
+        install(Config(**base, coroutines=True))
+        per_resume = drive(10)
+        uninstall()
+        clear_cache()
+        assert per_resume >= 18_000_000, f"Expected ~22ms of resume bumps, got {per_resume}ns"
+
+    @requires_pep669
+    def test_frequency_counted_per_task(self, tmp_path: Path) -> None:
+        """In coroutine mode the frequency counter key is task-qualified,
+        so interleaved tasks running the same coroutine do not share one
+        modulo counter."""
+        import asyncio
+
+        from speed_bump import _monitoring
+        from speed_bump._patterns import load_targets
+
+        targets_file = tmp_path / "targets.txt"
+        targets_file.write_text("*:*task_target\n")
+
+        targets = load_targets(targets_file)
+        now = time.time_ns()
+        install(
+            Config(
+                enabled=True,
+                targets=tuple(targets),
+                delay_ns=1000,
+                frequency=10,
+                start_ns=now - 1_000_000_000,
+                end_ns=None,
+                coroutines=True,
+            )
+        )
+        try:
+            code = self.test_frequency_counted_per_task.__code__
+            keys = []
+
+            async def probe() -> None:
+                keys.append(_monitoring._counter_key(code))
+
+            async def main() -> None:
+                await asyncio.gather(probe(), probe())
+
+            asyncio.run(main())
+
+            # Each task gets its own counter key over the same code object
+            assert len(keys) == 2
+            assert keys[0] != keys[1]
+            assert all(key[1] == id(code) for key in keys)
+        finally:
+            uninstall()
+            clear_cache()
+
+
+class TestLinePatterns:
+    """Tests for line-scoped patterns (per-line delays via LINE events)."""
+
+    @requires_pep669
+    def test_in_range_lines_bumped_per_execution(self, tmp_path: Path) -> None:
+        """Each execution of a line inside the scope pays one delay."""
+        from speed_bump._patterns import parse_pattern
+
+        def sectioned(n: int) -> int:
+            total = 0
+            for i in range(n):
+                total += i  # firstlineno + 3: the targeted line
+            for i in range(n):
+                total -= i  # outside the scope, must stay free
+            return total
+
+        target_line = sectioned.__code__.co_firstlineno + 3
+        now = time.time_ns()
+        install(
+            Config(
+                enabled=True,
+                targets=(parse_pattern(f"*:*sectioned:{target_line}", 1),),
+                delay_ns=1_000_000,
+                frequency=1,
+                start_ns=now - 1_000_000_000,
+                end_ns=None,
+            )
+        )
+        try:
+            start = time.perf_counter_ns()
+            sectioned(20)
+            elapsed = time.perf_counter_ns() - start
+        finally:
+            uninstall()
+            clear_cache()
+
+        # 20 executions of the targeted line at 1ms each; the second
+        # loop's line is outside the range and contributes nothing
+        assert elapsed >= 18_000_000, f"Expected ~20ms of line bumps, got {elapsed}ns"
+        assert elapsed < 45_000_000, f"Line bumps overshot: {elapsed}ns"
+
+    @requires_pep669
+    def test_out_of_range_lines_free(self, tmp_path: Path) -> None:
+        """A scope covering no executed lines injects no delay."""
+        from speed_bump._patterns import parse_pattern
+
+        def sectioned(n: int) -> int:
+            total = 0
+            for i in range(n):
+                total += i
+            return total
+
+        # A range far past the function body
+        target_line = sectioned.__code__.co_firstlineno + 50
+        now = time.time_ns()
+        install(
+            Config(
+                enabled=True,
+                targets=(
+                    parse_pattern(f"*:*sectioned:{target_line}-{target_line + 5}", 1),
+                ),
+                delay_ns=1_000_000,
+                frequency=1,
+                start_ns=now - 1_000_000_000,
+                end_ns=None,
+            )
+        )
+        try:
+            start = time.perf_counter_ns()
+            sectioned(50)
+            elapsed = time.perf_counter_ns() - start
+        finally:
+            uninstall()
+            clear_cache()
+
+        assert elapsed < 10_000_000, f"Out-of-range scope leaked delays: {elapsed}ns"
+
+
+class TestCCalls:
+    """Tests for C-call interception (CALL events for builtin callables)."""
+
+    @requires_pep669
+    def test_matched_builtin_bumped_per_call(self, tmp_path: Path) -> None:
+        """A builtin matched by __module__:__qualname__ pays one delay per call."""
+        from speed_bump._patterns import parse_pattern
+
+        now = time.time_ns()
+        install(
+            Config(
+                enabled=True,
+                targets=(parse_pattern("time:sleep", 1),),
+                delay_ns=1_000_000,
+                frequency=1,
+                start_ns=now - 1_000_000_000,
+                end_ns=None,
+                c_calls=True,
+            )
+        )
+        try:
+            start = time.perf_counter_ns()
+            for _ in range(20):
+                time.sleep(0)
+            elapsed = time.perf_counter_ns() - start
+        finally:
+            uninstall()
+            clear_cache()
+
+        assert elapsed >= 18_000_000, f"Expected ~20ms of C-call bumps, got {elapsed}ns"
+        assert elapsed < 60_000_000, f"C-call bumps overshot: {elapsed}ns"
+
+    @requires_pep669
+    def test_python_functions_not_double_bumped(self, tmp_path: Path) -> None:
+        """A matched Python function is bumped by PY_START only, not CALL too."""
+        from speed_bump._patterns import parse_pattern
+
+        def plain_probe() -> int:
+            return 1
+
+        now = time.time_ns()
+        install(
+            Config(
+                enabled=True,
+                targets=(parse_pattern("*:*plain_probe", 1),),
+                delay_ns=1_000_000,
+                frequency=1,
+                start_ns=now - 1_000_000_000,
+                end_ns=None,
+                c_calls=True,
+            )
+        )
+        try:
+            start = time.perf_counter_ns()
+            for _ in range(20):
+                plain_probe()
+            elapsed = time.perf_counter_ns() - start
+        finally:
+            uninstall()
+            clear_cache()
+
+        # 20 calls at 1ms each; a double bump would land near 40ms
+        assert 18_000_000 <= elapsed < 35_000_000, (
+            f"Expected one bump per call (~20ms), got {elapsed}ns"
+        )
+
 
 class TestCaching:
     """Tests for match result caching."""
@@ -330,6 +1041,104 @@ class TestCaching:
         # Should be fast since new targets don't match
         assert elapsed < 10_000_000
 
+    @requires_pep669
+    def test_concurrent_classification_agrees(self, tmp_path: Path) -> None:
+        """Threads classifying the same code objects concurrently all
+        see the same verdicts, and clear_cache retires every thread's
+        private cache (the caches take no lock, so nothing serialises)."""
+        import threading
+
+        from speed_bump import _monitoring
+        from speed_bump._patterns import load_targets
+
+        targets_file = tmp_path / "targets.txt"
+        targets_file.write_text("*:*classified_function\n")
+
+        targets = load_targets(targets_file)
+        now = time.time_ns()
+        config = Config(
+            enabled=True,
+            targets=tuple(targets),
+            delay_ns=0,
+            frequency=1,
+            start_ns=now - 1_000_000_000,
+            end_ns=None,
+        )
+
+        def classified_function() -> int:
+            return 42
+
+        code = classified_function.__code__
+        results: list[object] = []
+        barrier = threading.Barrier(8)
+
+        def worker() -> None:
+            barrier.wait()
+            for _ in range(100):
+                results.append(_monitoring._check_match(code, config))
+
+        threads = [threading.Thread(target=worker) for _ in range(8)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+
+        assert all(r == results[0] for r in results)
+        assert results[0] is not None  # It matched
+
+        # Invalidation must reach the per-thread caches too
+        clear_cache()
+        config2 = Config(
+            enabled=True,
+            targets=(),
+            delay_ns=0,
+            frequency=1,
+            start_ns=now - 1_000_000_000,
+            end_ns=None,
+        )
+        assert _monitoring._check_match(code, config2) is None
+
+
+class TestNativeHandler:
+    """Tests for the native PY_START callback on 3.12+."""
+
+    @requires_pep669
+    def test_native_handler_available(self) -> None:
+        """_core provides the native callback and it is preferred."""
+        from speed_bump import _core, _monitoring
+
+        assert _monitoring._HAVE_NATIVE_HANDLER is True
+        assert callable(_core.monitoring_callback)
+
+    @requires_pep669
+    def test_native_handler_delays_matching_calls(self, tmp_path: Path) -> None:
+        """The native callback applies delays like the Python handler."""
+        from speed_bump._patterns import load_targets
+
+        targets_file = tmp_path / "targets.txt"
+        targets_file.write_text("*:*native_handler_test\n")
+
+        targets = load_targets(targets_file)
+        config = Config(
+            enabled=True,
+            targets=tuple(targets),
+            delay_ns=1_000_000,  # 1ms
+            frequency=1,
+            start_ns=0,
+            end_ns=None,
+        )
+        install(config)
+
+        def native_handler_test() -> int:
+            return 42
+
+        start = time.time_ns()
+        for _ in range(20):
+            native_handler_test()
+        elapsed = time.time_ns() - start
+
+        assert elapsed >= 20_000_000, f"20 calls at 1ms took only {elapsed}ns"
+
 
 class TestGetConfig:
     """Tests for get_config function."""
@@ -95,6 +95,213 @@ class TestProbeContextManager:
             assert calls[1][0][0] == "-/bin/test:sym"
 
 
+class TestBatchProbes:
+    """Tests for the batched multi-probe API."""
+
+    def test_format_add_batch_joins_lines(self) -> None:
+        """Batch formatting emits one '+' line per spec."""
+        batch = native.format_add_batch(
+            [("/usr/bin/python3", "PyObject_GetAttr"),
+             ("/usr/bin/python3", "PyObject_SetAttr", 5000)],
+            delay_ns=1000,
+            pid=42,
+        )
+        assert batch == (
+            "+/usr/bin/python3:PyObject_GetAttr 1000 pid=42\n"
+            "+/usr/bin/python3:PyObject_SetAttr 5000 pid=42"
+        )
+
+    def test_format_remove_batch_joins_lines(self) -> None:
+        """Batch removal emits one '-' line per spec, ignoring delays."""
+        batch = native.format_remove_batch(
+            [("/usr/bin/python3", "PyObject_GetAttr"),
+             ("/usr/bin/python3", "PyObject_SetAttr", 5000)]
+        )
+        assert batch == (
+            "-/usr/bin/python3:PyObject_GetAttr\n"
+            "-/usr/bin/python3:PyObject_SetAttr"
+        )
+
+    def test_add_probes_single_write(self) -> None:
+        """add_probes writes the whole batch in one sysfs write."""
+        specs = [("/bin/a", "f"), ("/bin/b", "g")]
+        with mock.patch("builtins.open", mock.mock_open()) as mock_file:
+            native.add_probes(specs, delay_ns=100, pid=7)
+            mock_file.assert_called_once_with(native.SYSFS_TARGETS, "w")
+            mock_file().write.assert_called_once_with(
+                "+/bin/a:f 100 pid=7\n+/bin/b:g 100 pid=7"
+            )
+
+    def test_add_probes_empty_is_noop(self) -> None:
+        """An empty batch performs no write."""
+        with mock.patch("builtins.open", mock.mock_open()) as mock_file:
+            native.add_probes([])
+            mock_file.assert_not_called()
+
+    def test_malformed_spec_raises(self) -> None:
+        """A spec that is not a 2- or 3-tuple raises ValueError."""
+        with pytest.raises(ValueError, match="probe spec"):
+            native.format_add_batch([("/bin/a",)])
+
+    def test_probe_set_adds_and_removes_in_two_writes(self) -> None:
+        """probe_set does one write on entry and one on exit."""
+        specs = [("/bin/a", "f", 200), ("/bin/b", "g")]
+        with mock.patch("builtins.open", mock.mock_open()) as mock_file:
+            with native.probe_set(specs, delay_ns=100, pid=9):
+                pass
+            calls = mock_file().write.call_args_list
+            assert len(calls) == 2
+            assert calls[0][0][0] == "+/bin/a:f 200 pid=9\n+/bin/b:g 100 pid=9"
+            assert calls[1][0][0] == "-/bin/a:f\n-/bin/b:g"
+
+    def test_probe_set_removes_on_exception(self) -> None:
+        """probe_set removes the batch even if the body raises."""
+        with mock.patch("builtins.open", mock.mock_open()) as mock_file:
+            with pytest.raises(ValueError, match="test exception"):
+                with native.probe_set([("/bin/a", "f")], delay_ns=50, pid=1):
+                    raise ValueError("test exception")
+            calls = mock_file().write.call_args_list
+            assert len(calls) == 2
+            assert calls[1][0][0] == "-/bin/a:f"
+
+
+class TestProbeStats:
+    """Tests for the stats read path (no kernel module required)."""
+
+    REPORT = (
+        "/usr/bin/python3:PyObject_GetAttr hits=1234 total_delay_ns=1234000\n"
+        "/usr/bin/python3:PyObject_SetAttr hits=0 total_delay_ns=0\n"
+        "/usr/lib/libcudart.so:cudaLaunchKernel hits=77 total_delay_ns=77000\n"
+    )
+
+    def test_parse_stats_parses_lines(self) -> None:
+        """Each well-formed line becomes a ProbeStats entry."""
+        entries = native.parse_stats(self.REPORT)
+        assert len(entries) == 3
+        first = entries[0]
+        assert first.binary_path == "/usr/bin/python3"
+        assert first.symbol == "PyObject_GetAttr"
+        assert first.hits == 1234
+        assert first.total_delay_ns == 1234000
+
+    def test_parse_stats_skips_malformed_lines(self) -> None:
+        """Comments, blanks and unparseable lines are skipped."""
+        text = (
+            "# speed_bump probe stats\n"
+            "\n"
+            "no-colon-here hits=1 total_delay_ns=1\n"
+            "/bin/a:f hits=abc total_delay_ns=1\n"
+            "/bin/a:f hits=5\n"
+            "/bin/a:f hits=5 total_delay_ns=500 extra=field\n"
+        )
+        entries = native.parse_stats(text)
+        assert len(entries) == 1
+        assert entries[0].hits == 5
+
+    def test_stats_filters_by_binary_and_glob(self) -> None:
+        """stats() filters by binary path and fnmatch symbol glob."""
+        with mock.patch("builtins.open", mock.mock_open(read_data=self.REPORT)):
+            everything = native.stats()
+            py_only = native.stats(binary_path="/usr/bin/python3")
+            getters = native.stats(symbol="PyObject_Get*")
+        assert len(everything) == 3
+        assert [e.symbol for e in py_only] == ["PyObject_GetAttr", "PyObject_SetAttr"]
+        assert [e.symbol for e in getters] == ["PyObject_GetAttr"]
+
+    def test_probe_report_returns_hits(self) -> None:
+        """probe(report=True) fills the yielded dict with hit counts."""
+        with mock.patch.object(native, "_write_target"), mock.patch.object(
+            native, "stats", return_value=native.parse_stats(self.REPORT)[:1]
+        ), mock.patch.object(native, "_warn") as mock_warn:
+            with native.probe(
+                "/usr/bin/python3", "PyObject_GetAttr", pid=1, report=True
+            ) as hits:
+                assert hits == {}
+        assert hits == {"PyObject_GetAttr": 1234}
+        mock_warn.assert_not_called()
+
+    def test_probe_report_warns_on_zero_hits(self) -> None:
+        """A probe that never fired is warned about on exit."""
+        with mock.patch.object(native, "_write_target"), mock.patch.object(
+            native, "stats", return_value=[]
+        ), mock.patch.object(native, "_warn") as mock_warn:
+            with native.probe("/bin/a", "mistyped_symbol", pid=1, report=True):
+                pass
+        mock_warn.assert_called_once()
+        assert "no hits" in mock_warn.call_args[0][0]
+
+    def test_probe_report_warns_when_stats_missing(self) -> None:
+        """A module without stats support warns instead of raising."""
+        with mock.patch.object(native, "_write_target") as mock_write, mock.patch.object(
+            native, "stats", side_effect=OSError("no such file")
+        ), mock.patch.object(native, "_warn") as mock_warn:
+            with native.probe("/bin/a", "f", pid=1, report=True):
+                pass
+        mock_warn.assert_called_once()
+        # The probe is still removed after the failed read
+        assert mock_write.call_args_list[-1][0][0] == "-/bin/a:f"
+
+    def test_probe_without_report_yields_none(self) -> None:
+        """The default probe() behaviour is unchanged."""
+        with mock.patch.object(native, "_write_target"):
+            with native.probe("/bin/a", "f", pid=1) as hits:
+                assert hits is None
+
+
+class TestSymbolIndex:
+    """Tests for the ELF symbol index (parses the built C extension)."""
+
+    @pytest.fixture
+    def core_so(self, tmp_path, monkeypatch) -> str:
+        """Path to the _core extension, with the cache redirected."""
+        from speed_bump import _core
+
+        monkeypatch.setattr(native, "SYMBOL_CACHE_DIR", str(tmp_path / "symcache"))
+        return _core.__file__
+
+    def test_list_symbols_finds_module_init(self, core_so: str) -> None:
+        """The extension's PyInit entry point is in the dynamic table."""
+        symbols = native.list_symbols(core_so)
+        assert "PyInit__core" in symbols
+        assert symbols == sorted(symbols)
+
+    def test_list_symbols_uses_cache(self, core_so: str) -> None:
+        """A second call is served from the disk cache."""
+        first = native.list_symbols(core_so)
+        assert os.path.isdir(native.SYMBOL_CACHE_DIR)
+        with mock.patch.object(native, "_parse_dynsym") as mock_parse:
+            second = native.list_symbols(core_so)
+        mock_parse.assert_not_called()
+        assert second == first
+
+    def test_expand_symbols_globs(self, core_so: str) -> None:
+        """expand_symbols filters the index with fnmatch semantics."""
+        assert native.expand_symbols(core_so, "PyInit_*") == ["PyInit__core"]
+        assert native.expand_symbols(core_so, "no_such_symbol_*") == []
+
+    def test_not_elf_raises(self, tmp_path, monkeypatch) -> None:
+        """A non-ELF file raises ValueError."""
+        monkeypatch.setattr(native, "SYMBOL_CACHE_DIR", str(tmp_path / "symcache"))
+        bogus = tmp_path / "not_elf.bin"
+        bogus.write_bytes(b"definitely not an ELF header")
+        with pytest.raises(ValueError, match="not an ELF"):
+            native.list_symbols(str(bogus))
+
+    def test_wildcard_add_probe_batches(self, core_so: str) -> None:
+        """add_probe with a glob expands and writes one batch."""
+        native.list_symbols(core_so)  # warm the cache
+        with mock.patch.object(native, "_write_target") as mock_write:
+            native.add_probe(core_so, "PyInit_*", delay_ns=100, pid=7)
+        mock_write.assert_called_once_with(f"+{core_so}:PyInit__core 100 pid=7")
+
+    def test_wildcard_no_match_raises(self, core_so: str) -> None:
+        """A glob matching no symbols raises instead of probing nothing."""
+        with mock.patch.object(native, "_write_target") as mock_write:
+            with pytest.raises(ValueError, match="no symbols matching"):
+                native.add_probe(core_so, "zz_no_such_*")
+        mock_write.assert_not_called()
+
+
 class TestIsAvailable:
     """Tests for is_available function."""
 
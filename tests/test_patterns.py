@@ -7,8 +7,10 @@ from pathlib import Path
 import pytest
 
 from speed_bump._patterns import (
+    CompiledMatcher,
     PatternError,
     TargetPattern,
+    compile_matcher,
     load_targets,
     matches_any,
     parse_pattern,
@@ -58,6 +60,132 @@ class TestParsePattern:
         assert "Line 7" in str(exc_info.value)
         assert "Empty name" in str(exc_info.value)
 
+    def test_no_overrides_by_default(self) -> None:
+        """Patterns without override fields have None overrides."""
+        pattern = parse_pattern("module:name", 1)
+        assert pattern.delay_ns is None
+        assert pattern.frequency is None
+
+    def test_delay_and_frequency_overrides(self) -> None:
+        """delay_ns= and freq= fields are parsed as per-pattern overrides."""
+        pattern = parse_pattern("transformers.*:*Attention* delay_ns=50000 freq=10", 1)
+        assert pattern.module_pattern == "transformers.*"
+        assert pattern.name_pattern == "*Attention*"
+        assert pattern.delay_ns == 50000
+        assert pattern.frequency == 10
+
+    def test_overrides_with_whitespace_pattern(self) -> None:
+        """Overrides still parse when the pattern has internal whitespace."""
+        pattern = parse_pattern("module : name freq=2", 1)
+        assert pattern.module_pattern == "module"
+        assert pattern.name_pattern == "name"
+        assert pattern.frequency == 2
+
+    def test_unknown_override_raises(self) -> None:
+        """An unknown key=value field raises PatternError."""
+        with pytest.raises(PatternError) as exc_info:
+            parse_pattern("module:name bogus=1", 4)
+        assert "Line 4" in str(exc_info.value)
+        assert "bogus" in str(exc_info.value)
+
+    def test_non_integer_override_raises(self) -> None:
+        """A non-integer override value raises PatternError."""
+        with pytest.raises(PatternError) as exc_info:
+            parse_pattern("module:name delay_ns=fast", 2)
+        assert "Line 2" in str(exc_info.value)
+
+    def test_negative_delay_raises(self) -> None:
+        """A negative delay_ns raises PatternError."""
+        with pytest.raises(PatternError):
+            parse_pattern("module:name delay_ns=-1", 1)
+
+    def test_zero_frequency_raises(self) -> None:
+        """freq below 1 raises PatternError."""
+        with pytest.raises(PatternError):
+            parse_pattern("module:name freq=0", 1)
+
+    def test_rate_override_parses(self) -> None:
+        """rate= fields parse as a float bumps-per-second cap."""
+        pattern = parse_pattern("vllm.*:Sampler.forward rate=200", 1)
+        assert pattern.rate == 200.0
+
+    def test_fractional_rate_parses(self) -> None:
+        """Fractional rates (less than one bump per second) are valid."""
+        pattern = parse_pattern("module:name rate=0.5", 1)
+        assert pattern.rate == 0.5
+
+    def test_no_rate_by_default(self) -> None:
+        """Patterns without rate= have no rate cap."""
+        assert parse_pattern("module:name freq=10", 1).rate is None
+
+    def test_non_positive_rate_raises(self) -> None:
+        """rate must be greater than zero."""
+        with pytest.raises(PatternError):
+            parse_pattern("module:name rate=0", 1)
+        with pytest.raises(PatternError) as exc_info:
+            parse_pattern("module:name rate=fast", 5)
+        assert "Line 5" in str(exc_info.value)
+
+    def test_caller_pattern_parses(self) -> None:
+        """A <-caller suffix qualifies the pattern with a caller glob."""
+        pattern = parse_pattern("torch.nn.functional:linear<-LlamaAttention.forward", 1)
+        assert pattern.module_pattern == "torch.nn.functional"
+        assert pattern.name_pattern == "linear"
+        assert pattern.caller_pattern == "LlamaAttention.forward"
+
+    def test_no_caller_pattern_by_default(self) -> None:
+        """Patterns without <- have no caller constraint."""
+        pattern = parse_pattern("module:name", 1)
+        assert pattern.caller_pattern is None
+
+    def test_caller_pattern_with_overrides(self) -> None:
+        """The caller suffix combines with override fields."""
+        pattern = parse_pattern("m:f<-Cls.meth delay_ns=5000 freq=2", 1)
+        assert pattern.caller_pattern == "Cls.meth"
+        assert pattern.delay_ns == 5000
+        assert pattern.frequency == 2
+
+    def test_empty_caller_pattern_raises(self) -> None:
+        """A bare <- with no caller glob raises PatternError."""
+        with pytest.raises(PatternError) as exc_info:
+            parse_pattern("module:name<-", 3)
+        assert "Line 3" in str(exc_info.value)
+        assert "caller" in str(exc_info.value)
+
+    def test_line_range_parses(self) -> None:
+        """A :start-end suffix scopes the pattern to source lines."""
+        pattern = parse_pattern(
+            "vllm.worker.model_runner:ModelRunner.execute_model:212-240", 1
+        )
+        assert pattern.name_pattern == "ModelRunner.execute_model"
+        assert pattern.line_start == 212
+        assert pattern.line_end == 240
+
+    def test_single_line_parses(self) -> None:
+        """A :N suffix scopes the pattern to a single line."""
+        pattern = parse_pattern("module:func:7 delay_ns=5000", 1)
+        assert pattern.line_start == 7
+        assert pattern.line_end == 7
+        assert pattern.delay_ns == 5000
+
+    def test_no_line_scope_by_default(self) -> None:
+        """Patterns without a numeric suffix match the whole function."""
+        pattern = parse_pattern("module:name", 1)
+        assert pattern.line_start is None
+        assert pattern.line_end is None
+
+    def test_backwards_line_range_raises(self) -> None:
+        """A range whose end precedes its start raises PatternError."""
+        with pytest.raises(PatternError) as exc_info:
+            parse_pattern("module:func:9-3", 2)
+        assert "Line 2" in str(exc_info.value)
+
+    def test_line_scope_with_caller_raises(self) -> None:
+        """Line scoping and caller qualification cannot combine."""
+        with pytest.raises(PatternError) as exc_info:
+            parse_pattern("module:func:5-8<-Cls.meth", 1)
+        assert "caller" in str(exc_info.value)
+
 
 class TestTargetPatternMatching:
     """Tests for TargetPattern.matches method."""
@@ -99,6 +227,19 @@ class TestTargetPatternMatching:
         assert pattern.matches("modele", "func") is True
         assert pattern.matches("modle", "func") is False
 
+    def test_matches_caller(self) -> None:
+        """Caller-qualified patterns check the calling function's qualname."""
+        pattern = TargetPattern("m", "f", "m:f<-Attn.*", caller_pattern="Attn.*")
+        assert pattern.matches_caller("Attn.forward") is True
+        assert pattern.matches_caller("Mlp.forward") is False
+        assert pattern.matches_caller(None) is False
+
+    def test_matches_caller_unconstrained(self) -> None:
+        """Patterns without a caller constraint match any caller."""
+        pattern = TargetPattern("m", "f", "m:f")
+        assert pattern.matches_caller("anything") is True
+        assert pattern.matches_caller(None) is True
+
 
 class TestLoadTargets:
     """Tests for load_targets function."""
@@ -141,6 +282,83 @@ another.valid:pattern
         assert "Line 2" in str(exc_info.value)
 
 
+class TestCompiledMatcher:
+    """Tests for the combined-regex CompiledMatcher."""
+
+    CASES = [
+        ("transformers.*", "Llama*"),
+        ("mymodule", "MyClass.method"),
+        ("*", "func"),
+        ("mod?le", "func"),
+        ("pkg.[ab]mod", "Class.*"),
+        ("pkg.[!ab]mod", "*"),
+    ]
+
+    INPUTS = [
+        ("transformers.modeling_llama", "LlamaAttention"),
+        ("transformers.modeling_llama", "BertAttention"),
+        ("mymodule", "MyClass.method"),
+        ("mymodule", "MyClass.other"),
+        ("anymodule", "func"),
+        ("module", "func"),
+        ("modle", "func"),
+        ("pkg.amod", "Class.method"),
+        ("pkg.cmod", "anything"),
+    ]
+
+    def test_equivalent_to_per_pattern_matching(self) -> None:
+        """Combined matcher agrees with TargetPattern.matches on every input."""
+        patterns = tuple(
+            TargetPattern(m, n, f"{m}:{n}") for m, n in self.CASES
+        )
+        matcher = CompiledMatcher(patterns)
+        for module, name in self.INPUTS:
+            expected = any(p.matches(module, name) for p in patterns)
+            assert matcher.matches(module, name) is expected, (module, name)
+
+    def test_module_glob_cannot_cross_into_name(self) -> None:
+        """A '*' in the module glob must not swallow the name field."""
+        matcher = CompiledMatcher(
+            (TargetPattern("mod*", "specific", "mod*:specific"),)
+        )
+        assert matcher.matches("module", "specific") is True
+        assert matcher.matches("module", "other") is False
+
+    def test_empty_patterns_never_match(self) -> None:
+        """Empty pattern tuple yields a matcher that matches nothing."""
+        matcher = CompiledMatcher(())
+        assert matcher.matches("anything", "at.all") is False
+
+    def test_compile_matcher_is_cached(self) -> None:
+        """Repeated compile_matcher calls return the same object."""
+        patterns = (TargetPattern("m", "n", "m:n"),)
+        assert compile_matcher(patterns) is compile_matcher(patterns)
+
+    def test_find_match_returns_matching_pattern(self) -> None:
+        """find_match returns the pattern carrying its overrides."""
+        patterns = (
+            TargetPattern("mod_a", "*", "mod_a:*", delay_ns=50000, frequency=10),
+            TargetPattern("mod_b", "*", "mod_b:*"),
+        )
+        matcher = CompiledMatcher(patterns)
+        assert matcher.find_match("mod_a", "func") is patterns[0]
+        assert matcher.find_match("mod_b", "func") is patterns[1]
+        assert matcher.find_match("mod_c", "func") is None
+
+    def test_find_edge_match_honours_caller(self) -> None:
+        """find_edge_match resolves caller constraints, falling through a
+        failed caller-qualified pattern to later patterns."""
+        patterns = (
+            parse_pattern("m:f<-caller_a delay_ns=1", 1),
+            parse_pattern("m:f delay_ns=2", 2),
+        )
+        matcher = CompiledMatcher(patterns)
+        assert matcher.find_edge_match("m", "f", "caller_a") is patterns[0]
+        assert matcher.find_edge_match("m", "f", "caller_b") is patterns[1]
+        assert matcher.find_edge_match("m", "f", None) is patterns[1]
+        assert matcher.find_edge_match("m", "g", "caller_a") is None
+
+
 class TestMatchesAny:
     """Tests for matches_any function."""
 
@@ -0,0 +1,307 @@
+"""Tests for statistics collection and the stats file reader."""
+
+from __future__ import annotations
+
+import threading
+from pathlib import Path
+
+import pytest
+
+import speed_bump
+from speed_bump import stats
+from speed_bump._core import stats_record
+
+
+@pytest.fixture
+def stats_file(tmp_path: Path) -> Path:
+    """Path for a statistics output file."""
+    return tmp_path / "bumps.bin"
+
+
+class TestStatsLifecycle:
+    """Tests for starting and stopping collection."""
+
+    def test_disabled_by_default(self) -> None:
+        """Collection is not running unless started."""
+        assert speed_bump.stats_is_enabled() is False
+
+    def test_start_stop_round_trip(self, stats_file: Path) -> None:
+        """Start/stop produces a readable file with a valid header."""
+        speed_bump.stats_start(str(stats_file))
+        try:
+            assert speed_bump.stats_is_enabled() is True
+        finally:
+            speed_bump.stats_stop()
+
+        assert speed_bump.stats_is_enabled() is False
+        header = stats.read_header(stats_file)
+        assert header.version == 2
+        assert header.start_ts_ns > 0
+        assert header.clock_overhead_ns > 0
+        assert header.min_delay_ns > 0
+        assert header.meta == ()
+
+    def test_double_start_raises(self, stats_file: Path) -> None:
+        """Starting twice raises RuntimeError."""
+        speed_bump.stats_start(str(stats_file))
+        try:
+            with pytest.raises(RuntimeError):
+                speed_bump.stats_start(str(stats_file))
+        finally:
+            speed_bump.stats_stop()
+
+    def test_stop_without_start_is_noop(self) -> None:
+        """Stopping when not running does nothing."""
+        speed_bump.stats_stop()
+
+    def test_record_when_disabled_is_noop(self) -> None:
+        """Recording with collection disabled is a cheap no-op."""
+        stats_record(1, 1000)
+
+
+class TestStatsRecording:
+    """Tests for recording and reading back records."""
+
+    def test_records_round_trip(self, stats_file: Path) -> None:
+        """Recorded bumps come back with matching ids and delays."""
+        speed_bump.stats_start(str(stats_file))
+        try:
+            for i in range(100):
+                stats_record(42, 1000 + i)
+        finally:
+            speed_bump.stats_stop()
+
+        records = list(stats.read_records(stats_file))
+        assert len(records) == 100
+        assert all(r.code_id == 42 for r in records)
+        assert sorted(r.delay_ns for r in records) == list(range(1000, 1100))
+        assert all(r.ts_ns > 0 for r in records)
+
+    def test_multithreaded_recording(self, stats_file: Path) -> None:
+        """Records from concurrent threads are all captured."""
+        n_threads = 4
+        n_records = 500
+
+        def record_many(thread_id: int) -> None:
+            # Offset past the reserved marker ids (0 and 1)
+            for _ in range(n_records):
+                stats_record(thread_id + 10, 100)
+
+        speed_bump.stats_start(str(stats_file))
+        try:
+            threads = [
+                threading.Thread(target=record_many, args=(i,)) for i in range(n_threads)
+            ]
+            for t in threads:
+                t.start()
+            for t in threads:
+                t.join()
+        finally:
+            speed_bump.stats_stop()
+
+        counts = stats.hit_counts(stats_file)
+        dropped = speed_bump.stats_dropped()
+        assert sum(counts.values()) + dropped == n_threads * n_records
+
+    def test_hit_counts(self, stats_file: Path) -> None:
+        """hit_counts aggregates per code-object id."""
+        speed_bump.stats_start(str(stats_file))
+        try:
+            for _ in range(3):
+                stats_record(5, 100)
+            stats_record(6, 100)
+        finally:
+            speed_bump.stats_stop()
+
+        assert stats.hit_counts(stats_file) == {5: 3, 6: 1}
+
+    def test_phase_markers(self, stats_file: Path) -> None:
+        """Phase markers are separated from bump records."""
+        speed_bump.stats_start(str(stats_file))
+        try:
+            stats_record(stats.PHASE_MARKER_ID, 0)
+            stats_record(7, 100)
+            stats_record(stats.PHASE_MARKER_ID, 1000)
+            stats_record(7, 1000)
+        finally:
+            speed_bump.stats_stop()
+
+        markers = stats.phase_markers(stats_file)
+        assert [m.delay_ns for m in markers] == [0, 1000]
+        assert stats.hit_counts(stats_file) == {7: 2}
+
+
+class TestThroughputMarks:
+    """Tests for the speed_bump.mark() throughput marker API."""
+
+    def test_mark_when_disabled_is_noop(self) -> None:
+        """Marking with collection disabled is a cheap no-op."""
+        speed_bump.mark()
+        speed_bump.mark(32)
+
+    def test_marks_round_trip(self, stats_file: Path) -> None:
+        """Marked units come back interleaved with bump records."""
+        speed_bump.stats_start(str(stats_file))
+        try:
+            speed_bump.mark(16)
+            stats_record(7, 100)
+            speed_bump.mark(32)
+            speed_bump.mark()  # default: one unit
+        finally:
+            speed_bump.stats_stop()
+
+        marks = stats.throughput_marks(stats_file)
+        assert [m.units for m in marks] == [16, 32, 1]
+        assert all(m.ts_ns > 0 for m in marks)
+        # Markers are kept out of the bump aggregation
+        assert stats.hit_counts(stats_file) == {7: 1}
+
+
+class TestRunAggregation:
+    """Tests for aggregating a multi-process run directory."""
+
+    def test_aggregate_run_merges_per_pid_files(self, tmp_path: Path) -> None:
+        """Per-pid stats files merge into reports keyed by pid and role."""
+        # Two sequential sessions stand in for two processes
+        speed_bump.stats_start(str(tmp_path / "stats.111.bin"))
+        try:
+            for _ in range(3):
+                stats_record(7, 1000)
+            speed_bump.mark(40)
+        finally:
+            speed_bump.stats_stop()
+
+        speed_bump.stats_start(str(tmp_path / "stats.222.bin"))
+        try:
+            stats_record(9, 500)
+            speed_bump.mark(25)
+        finally:
+            speed_bump.stats_stop()
+
+        (tmp_path / "proc.111").write_text("role rank0\n")
+        (tmp_path / "bogus.bin").write_bytes(b"NOPE" + b"\x00" * 12)
+
+        reports = stats.aggregate_run(tmp_path)
+        assert [r.pid for r in reports] == [111, 222]
+
+        first, second = reports
+        assert first.role == "rank0"
+        assert first.hit_counts == {7: 3}
+        assert first.total_delay_ns == 3000
+        assert first.units == 40
+        assert second.role is None
+        assert second.hit_counts == {9: 1}
+        assert second.units == 25
+
+    def test_aggregate_missing_dir_is_empty(self, tmp_path: Path) -> None:
+        """A missing or empty run directory aggregates to nothing."""
+        assert stats.aggregate_run(tmp_path / "nope") == []
+        assert stats.aggregate_run(tmp_path) == []
+
+
+class TestStatsFormat:
+    """Tests for format validation."""
+
+    def test_bad_magic_raises(self, tmp_path: Path) -> None:
+        """A non-stats file raises StatsFormatError."""
+        bogus = tmp_path / "bogus.bin"
+        bogus.write_bytes(b"NOPE" + b"\x00" * 12)
+        with pytest.raises(stats.StatsFormatError, match="bad magic"):
+            stats.read_header(bogus)
+
+    def test_truncated_header_raises(self, tmp_path: Path) -> None:
+        """A truncated file raises StatsFormatError."""
+        short = tmp_path / "short.bin"
+        short.write_bytes(b"SB")
+        with pytest.raises(stats.StatsFormatError, match="truncated"):
+            stats.read_header(short)
+
+    def test_metadata_round_trips(self, stats_file: Path) -> None:
+        """A metadata string comes back as (key, value) pairs."""
+        speed_bump.stats_start(str(stats_file), "delay_ns 1000\ntarget a:*\ntarget b:*\n")
+        try:
+            stats_record(9, 100)
+        finally:
+            speed_bump.stats_stop()
+
+        header = stats.read_header(stats_file)
+        assert ("delay_ns", "1000") in header.meta
+        assert [v for k, v in header.meta if k == "target"] == ["a:*", "b:*"]
+        # Records still read past the variable-length header
+        assert stats.hit_counts(stats_file) == {9: 1}
+
+    def test_v1_file_still_reads(self, tmp_path: Path) -> None:
+        """Version 1 files (bare 16-byte header) remain readable."""
+        import struct
+
+        v1 = tmp_path / "v1.bin"
+        v1.write_bytes(
+            struct.pack("<4sIQ", b"SBST", 1, 123)
+            + struct.pack("<QQQ", 5, 1000, 2000)
+        )
+
+        header = stats.read_header(v1)
+        assert header.version == 1
+        assert header.start_ts_ns == 123
+        assert header.clock_overhead_ns == 0
+        assert header.meta == ()
+        assert stats.hit_counts(v1) == {5: 1}
+
+    def test_truncated_metadata_raises(self, tmp_path: Path) -> None:
+        """A v2 header whose metadata block is cut short raises."""
+        import struct
+
+        bad = tmp_path / "bad.bin"
+        bad.write_bytes(
+            struct.pack("<4sIQ", b"SBST", 2, 123)
+            + struct.pack("<QQQI", 1, 1, 1, 100)  # claims 100 metadata bytes
+            + b"delay_ns 1000\n"
+        )
+        with pytest.raises(stats.StatsFormatError, match="truncated metadata"):
+            stats.read_header(bad)
+
+
+class TestReport:
+    """Tests for the speed-bump-report tool."""
+
+    def _write_sample(self, path: Path) -> None:
+        """Record two phases of bumps with throughput marks."""
+        speed_bump.stats_start(str(path), "delay_ns 0\ntarget sample:*\n")
+        try:
+            stats_record(stats.PHASE_MARKER_ID, 0)
+            for _ in range(4):
+                stats_record(50, 0)
+                stats_record(stats.THROUGHPUT_MARKER_ID, 10)
+            stats_record(stats.PHASE_MARKER_ID, 1000)
+            for _ in range(2):
+                stats_record(50, 1000)
+                stats_record(stats.THROUGHPUT_MARKER_ID, 10)
+        finally:
+            speed_bump.stats_stop()
+
+    def test_report_renders_tables(self, stats_file: Path) -> None:
+        """The report shows header, per-code and per-phase sections."""
+        import io
+
+        from speed_bump import report
+
+        self._write_sample(stats_file)
+        out = io.StringIO()
+        report.render_report(str(stats_file), out=out)
+        text = out.getvalue()
+
+        assert "format v2" in text
+        assert "target sample:*" in text
+        assert "6 bumps" in text
+        assert f"{50:#x}" in text  # per-code table row
+        assert "phase_delay" in text
+        assert "units/s" in text
+
+    def test_main_reports_bad_file(self, tmp_path: Path, capsys) -> None:
+        """A non-stats file produces an error and a nonzero exit."""
+        from speed_bump import report
+
+        bogus = tmp_path / "bogus.bin"
+        bogus.write_bytes(b"NOPE" + b"\x00" * 12)
+        assert report.main([str(bogus)]) == 1
+        assert "bad magic" in capsys.readouterr().err